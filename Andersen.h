@@ -0,0 +1,469 @@
+/************************************************************************
+ *
+ * @file Andersen.h
+ *
+ * Flow-insensitive, inclusion-based (Andersen) pointer analysis of the
+ * whole module, with lazy cycle detection
+ *
+ ***********************************************************************/
+
+#ifndef ANDERSEN_H
+#define ANDERSEN_H
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "GlobalInitializers.h"
+#include "MemoryModel.h"
+#include "PTA.h"
+#include "SignatureIndex.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// One points-to set per SSA pointer and per memory location (object, byte
+/// offset) for the whole program, from the same instructions PTAVisitor
+/// handles: alloca and allocation calls create objects; GEP, cast, phi and
+/// select are copy edges (a GEP's carries its byte offset); loads and stores
+/// add edges from and to the memory nodes their address points to; calls bind
+/// actuals to formals and return values to the call, indirect ones as their
+/// targets are discovered; memcpy copies every field of its source range.
+/// A call to an allocation wrapper is its own object, with a copy of what the
+/// wrapper allocated, as in PTAVisitor.
+///
+/// Sets are propagated as differences. Cycles of copy edges are found lazily
+/// (Hardekopf and Lin): when an edge leaves its endpoints with equal sets,
+/// a cycle through it is likely, so the nodes reachable from there are
+/// searched and every cycle found is collapsed into one node.
+///
+/// The report is the same as PTAVisitor's: the targets of every call site in
+/// the functions reachable from the entry.
+///
+class AndersenPTA {
+public:
+    AndersenPTA(Module &M, Function *entry, unsigned threads)
+            : module(M), entry(entry), DL(M.getDataLayout()), signatures(M), globals(M, threads) {}
+
+    void run() {
+        auto start = std::chrono::steady_clock::now();
+        solveModule();
+        report();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "Andersen: " << (int) nodes.size() << " nodes, " << (int) collapsed
+             << " collapsed into cycles, solved in " << (int) us << "us. \n";
+    }
+
+    /// Build and solve the constraints of the whole module, for the modes
+    /// that use this one as their pre-analysis.
+    void solveModule() {
+        buildConstraints();
+        do {
+            solve();
+        } while (applyMemCpys());
+    }
+
+    /// Solved points-to set of an SSA pointer or constant.
+    std::set<MemLoc> pointsTo(Value *v) {
+        return nodes[varNode(v)].pts;
+    }
+
+    /// The memory locations in [start, start + length) of start's object
+    /// that the solution has a node for.
+    std::vector<MemLoc> locationsIn(const MemLoc &start, int64_t length) const {
+        std::vector<MemLoc> locs;
+        for (auto it = memNodes.lower_bound(start);
+             it != memNodes.end() && it->first.first == start.first &&
+             it->first.second - start.second < length; ++it) {
+            locs.push_back(it->first);
+        }
+        return locs;
+    }
+
+    /// Targets of call: its constant callee, or the functions the called
+    /// pointer points to, minus the ones whose signature can't match.
+    std::set<Function *> targetsOf(CallInst *call) {
+        std::set<Function *> targets;
+        for (const auto &loc: nodes[varNode(call->getCalledOperand())].pts) {
+            auto *F = dyn_cast<Function>(loc.first);
+            if (F && loc.second == 0 && signatures.mayCall(call, F))
+                targets.insert(F);
+        }
+        return targets;
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    struct Node {
+        std::set<MemLoc> pts;
+        std::set<MemLoc> delta;                        // 上次传播之后新加的
+        std::set<std::pair<unsigned, int64_t>> succs;  // (dst, 偏移增量)，拷贝边的增量为0
+        std::vector<unsigned> loads;                   // 以本节点为地址的load结果
+        std::vector<unsigned> stores;                  // 以本节点为地址存进去的值
+        std::vector<CallInst *> calls;                 // 以本节点为被调用操作数的调用
+        unsigned parent;                               // 并查集，环上的节点合并成一个
+        bool queued = false;
+    };
+
+    struct MemCpy {
+        unsigned dest;
+        unsigned src;
+        int64_t length;
+    };
+
+    Module &module;
+    Function *entry;
+    DataLayout DL;
+    SignatureIndex signatures;
+    GlobalInitializers globals;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+
+    std::vector<Node> nodes;
+    std::map<Value *, unsigned> varNodes;
+    std::map<MemLoc, unsigned> memNodes;
+    std::vector<MemCpy> memCpys;
+    std::set<std::pair<CallInst *, Function *>> boundCalls;
+    std::set<std::pair<unsigned, unsigned>> checkedEdges;  // 已经因为它找过环的边
+    std::deque<unsigned> worklist;
+    unsigned collapsed = 0;
+
+    unsigned newNode() {
+        nodes.emplace_back();
+        nodes.back().parent = nodes.size() - 1;
+        return nodes.size() - 1;
+    }
+
+    unsigned find(unsigned n) {
+        while (nodes[n].parent != n) {
+            nodes[n].parent = nodes[nodes[n].parent].parent;
+            n = nodes[n].parent;
+        }
+        return n;
+    }
+
+    /// Node of an SSA pointer; constants start out with what they point to.
+    unsigned varNode(Value *v) {
+        auto it = varNodes.find(v);
+        if (it != varNodes.end()) return find(it->second);
+        unsigned n = varNodes[v] = newNode();
+        if (auto *C = dyn_cast<Constant>(v)) {
+            for (const auto &loc: constantPts(C, DL)) {
+                addPts(n, loc);
+            }
+        }
+        return n;
+    }
+
+    unsigned memNode(const MemLoc &loc) {
+        auto it = memNodes.find(loc);
+        if (it != memNodes.end()) return find(it->second);
+        unsigned n = memNodes[loc] = newNode();
+        if (auto *initial = globals.lookup(loc)) {
+            for (const auto &target: *initial) {
+                addPts(n, target);
+            }
+        }
+        return n;
+    }
+
+    void enqueue(unsigned n) {
+        if (nodes[n].queued) return;
+        nodes[n].queued = true;
+        worklist.push_back(n);
+    }
+
+    bool addPts(unsigned n, const MemLoc &loc) {
+        n = find(n);
+        if (!nodes[n].pts.insert(loc).second) return false;
+        nodes[n].delta.insert(loc);
+        enqueue(n);
+        return true;
+    }
+
+    /// A new edge carries everything the source already points to.
+    void addEdge(unsigned src, unsigned dst, int64_t delta = 0) {
+        src = find(src);
+        dst = find(dst);
+        if (src == dst && delta == 0) return;
+        if (!nodes[src].succs.insert({dst, delta}).second) return;
+        for (const auto &loc: std::set<MemLoc>(nodes[src].pts)) {
+            addPts(dst, fieldAt(loc.first, loc.second + delta, DL));
+        }
+    }
+
+    void buildConstraints() {
+        // 全局变量的初始内容，memcpy可能从还没被读写过的全局变量里拷贝
+        for (const auto &fact: globals.getFacts()) {
+            memNode(fact.first);
+        }
+        for (auto &F: module) {
+            for (auto &I: instructions(F)) {
+                if (isa<DbgInfoIntrinsic>(&I)) continue;
+                if (auto *alloca = dyn_cast<AllocaInst>(&I)) {
+                    addPts(varNode(alloca), MemLoc(alloca, 0));
+                } else if (auto *store = dyn_cast<StoreInst>(&I)) {
+                    if (!store->getValueOperand()->getType()->isPointerTy()) continue;
+                    unsigned val = varNode(store->getValueOperand());
+                    unsigned ptr = varNode(store->getPointerOperand());
+                    nodes[ptr].stores.push_back(val);
+                    enqueue(ptr);
+                } else if (auto *load = dyn_cast<LoadInst>(&I)) {
+                    if (!load->getType()->isPointerTy()) continue;
+                    unsigned dst = varNode(load);
+                    unsigned ptr = varNode(load->getPointerOperand());
+                    nodes[ptr].loads.push_back(dst);
+                    enqueue(ptr);
+                } else if (auto *gep = dyn_cast<GetElementPtrInst>(&I)) {
+                    addEdge(varNode(gep->getPointerOperand()), varNode(gep),
+                            gepOffset(cast<GEPOperator>(gep), DL));
+                } else if (auto *memCpy = dyn_cast<MemTransferInst>(&I)) {
+                    auto *len = dyn_cast<ConstantInt>(memCpy->getLength());
+                    memCpys.push_back({varNode(memCpy->getRawDest()), varNode(memCpy->getRawSource()),
+                                       len ? len->getSExtValue() : INT64_MAX});
+                } else if (isa<BitCastInst>(&I) || isa<AddrSpaceCastInst>(&I)) {
+                    if (I.getType()->isPointerTy())
+                        addEdge(varNode(I.getOperand(0)), varNode(&I));
+                } else if (auto *phi = dyn_cast<PHINode>(&I)) {
+                    if (!phi->getType()->isPointerTy()) continue;
+                    for (Value *in: phi->incoming_values()) {
+                        addEdge(varNode(in), varNode(phi));
+                    }
+                } else if (auto *select = dyn_cast<SelectInst>(&I)) {
+                    if (!select->getType()->isPointerTy()) continue;
+                    addEdge(varNode(select->getTrueValue()), varNode(select));
+                    addEdge(varNode(select->getFalseValue()), varNode(select));
+                } else if (auto *call = dyn_cast<CallInst>(&I)) {
+                    if (!isa<MemSetInst>(call))
+                        addCall(call);
+                }
+            }
+        }
+    }
+
+    void addCall(CallInst *call) {
+        auto *callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+        if (callee && callee->isDeclaration()) {
+            // C的分配函数：每个分配点是一个堆对象，realloc保留原来的内容
+            if (isAllocationCall(call)) {
+                addPts(varNode(call), MemLoc(call, 0));
+                if (callee->getName() == "realloc")
+                    memCpys.push_back({varNode(call), varNode(call->getArgOperand(0)), INT64_MAX});
+            }
+            return;
+        }
+        if (callee) {
+            bindCall(call, callee);
+            return;
+        }
+        unsigned n = varNode(call->getCalledOperand());
+        nodes[n].calls.push_back(call);
+        enqueue(n);
+    }
+
+    void bindCall(CallInst *call, Function *F) {
+        if (F->isDeclaration() || !boundCalls.insert({call, F}).second) return;
+        for (unsigned i = 0, num = call->getNumArgOperands(); i < num && i < F->arg_size(); ++i) {
+            if (call->getArgOperand(i)->getType()->isPointerTy())
+                addEdge(varNode(call->getArgOperand(i)), varNode(F->getArg(i)));
+        }
+        if (!call->getType()->isPointerTy()) return;
+        // 分配函数的包装：调用点是自己的对象，包装分配的对象的内容复制过来
+        unsigned result = varNode(call);
+        if (isAllocationCall(call)) {
+            addPts(result, MemLoc(call, 0));
+            result = newNode();
+            memCpys.push_back({varNode(call), result, INT64_MAX});
+        }
+        for (auto &BB: *F) {
+            auto *ret = dyn_cast<ReturnInst>(BB.getTerminator());
+            if (ret && ret->getReturnValue())
+                addEdge(varNode(ret->getReturnValue()), result);
+        }
+    }
+
+    void solve() {
+        while (!worklist.empty()) {
+            unsigned n = worklist.front();
+            worklist.pop_front();
+            nodes[n].queued = false;
+            if (find(n) == n)
+                propagate(n);
+        }
+    }
+
+    void propagate(unsigned n) {
+        std::set<MemLoc> delta;
+        delta.swap(nodes[n].delta);
+
+        // 拷贝一份，处理过程中nodes可能扩容
+        auto succs = nodes[n].succs;
+        for (const auto &succ: succs) {
+            unsigned dst = find(succ.first);
+            for (const auto &loc: delta) {
+                addPts(dst, fieldAt(loc.first, loc.second + succ.second, DL));
+            }
+            n = find(n);
+            if (succ.second == 0 && dst != n && nodes[dst].pts == nodes[n].pts &&
+                checkedEdges.insert({n, dst}).second)
+                collapseCycles(dst);
+        }
+
+        n = find(n);
+        auto loads = nodes[n].loads;
+        auto stores = nodes[n].stores;
+        auto calls = nodes[n].calls;
+        for (const auto &loc: delta) {
+            if (!loads.empty() || !stores.empty()) {
+                unsigned mem = memNode(loc);
+                for (unsigned dst: loads) {
+                    addEdge(mem, dst);
+                }
+                for (unsigned src: stores) {
+                    addEdge(src, mem);
+                }
+            }
+            auto *F = dyn_cast<Function>(loc.first);
+            if (!F || loc.second != 0) continue;
+            for (auto *call: calls) {
+                if (signatures.mayCall(call, F))
+                    bindCall(call, F);
+            }
+        }
+    }
+
+    /// Tarjan over the copy edges reachable from root, merging every cycle it
+    /// finds into the cycle's first node.
+    void collapseCycles(unsigned root) {
+        std::map<unsigned, unsigned> index, lowLink;
+        std::set<unsigned> onStack;
+        std::vector<unsigned> stack;
+        unsigned nextIndex = 0;
+
+        // 显式的DFS栈：(节点, 还没访问的后继)
+        typedef std::pair<unsigned, std::vector<unsigned>> Frame;
+        auto copySuccs = [this](unsigned n) {
+            std::vector<unsigned> succs;
+            for (const auto &succ: nodes[n].succs) {
+                unsigned dst = find(succ.first);
+                if (succ.second == 0 && dst != n)
+                    succs.push_back(dst);
+            }
+            return succs;
+        };
+
+        std::vector<Frame> dfs;
+        root = find(root);
+        index[root] = lowLink[root] = nextIndex++;
+        stack.push_back(root);
+        onStack.insert(root);
+        dfs.emplace_back(root, copySuccs(root));
+
+        while (!dfs.empty()) {
+            unsigned node = dfs.back().first;
+            auto &succs = dfs.back().second;
+
+            if (!succs.empty()) {
+                unsigned succ = succs.back();
+                succs.pop_back();
+                if (!index.count(succ)) {
+                    index[succ] = lowLink[succ] = nextIndex++;
+                    stack.push_back(succ);
+                    onStack.insert(succ);
+                    dfs.emplace_back(succ, copySuccs(succ));
+                } else if (onStack.count(succ)) {
+                    lowLink[node] = std::min(lowLink[node], index[succ]);
+                }
+                continue;
+            }
+
+            dfs.pop_back();
+            if (!dfs.empty()) {
+                unsigned parent = dfs.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+
+            if (lowLink[node] == index[node]) {
+                unsigned member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack.erase(member);
+                    if (member != node)
+                        unite(member, node);
+                } while (member != node);
+            }
+        }
+    }
+
+    /// Merge node from into node into, which then propagates everything again.
+    void unite(unsigned from, unsigned into) {
+        ++collapsed;
+        auto &src = nodes[from];
+        auto &dst = nodes[into];
+        src.parent = into;
+        dst.pts.insert(src.pts.begin(), src.pts.end());
+        dst.delta = dst.pts;
+        for (const auto &succ: src.succs) {
+            if (find(succ.first) != into || succ.second != 0)
+                dst.succs.insert(succ);
+        }
+        dst.loads.insert(dst.loads.end(), src.loads.begin(), src.loads.end());
+        dst.stores.insert(dst.stores.end(), src.stores.begin(), src.stores.end());
+        dst.calls.insert(dst.calls.end(), src.calls.begin(), src.calls.end());
+        src = Node{{}, {}, {}, {}, {}, {}, into, false};
+        enqueue(into);
+    }
+
+    /// memcpy(dest, src, len) copies every location of the source range to
+    /// the same offset of the destination range.
+    /// @return true if it added an edge, and there is something to solve
+    bool applyMemCpys() {
+        bool changed = false;
+        for (const auto &mc: memCpys) {
+            for (const auto &d: std::set<MemLoc>(nodes[find(mc.dest)].pts)) {
+                for (const auto &s: std::set<MemLoc>(nodes[find(mc.src)].pts)) {
+                    std::vector<std::pair<MemLoc, unsigned>> inRange;
+                    for (auto it = memNodes.lower_bound(s);
+                         it != memNodes.end() && it->first.first == s.first &&
+                         it->first.second - s.second < mc.length; ++it) {
+                        inRange.push_back(*it);
+                    }
+                    for (const auto &it: inRange) {
+                        unsigned from = find(it.second);
+                        unsigned to = memNode(fieldAt(d.first, d.second + it.first.second - s.second, DL));
+                        if (from != to && !nodes[from].succs.count({to, 0})) {
+                            addEdge(from, to);
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+
+    void report() {
+        reportReachableCalls(entry, [this](CallInst *call) { return targetsOf(call); }, &callResult);
+    }
+};
+
+#endif //ANDERSEN_H
@@ -0,0 +1,280 @@
+/************************************************************************
+ *
+ * @file BottomUp.h
+ *
+ * Bottom-up summary computation over the SCC DAG of the call graph
+ *
+ ***********************************************************************/
+
+#ifndef BOTTOMUP_H
+#define BOTTOMUP_H
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "CallGraph.h"
+#include "GlobalInitializers.h"
+#include "PTA.h"
+#include "PointerEquivalence.h"
+#include "PointerFree.h"
+#include "SignatureIndex.h"
+#include "TypeRelevance.h"
+#include "ThreadPool.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Summarizes every function of the module bottom-up. Every SCC is handed to
+/// the thread pool at the start of a round, callees first; a summary that
+/// reaches a call whose callee's SCC is not published yet suspends there and
+/// is requeued once that SCC publishes, so callers overlap with their callees
+/// instead of starting after them. A call into the own SCC, or one whose wait
+/// would close a cycle of suspended SCCs (an indirect edge the call graph
+/// doesn't have yet), uses the summary at hand instead. Indirect edges found
+/// while applying summaries are added to the call graph and the whole DAG is
+/// recomputed, until a round discovers no new edge.
+///
+class BottomUpPTA {
+public:
+    BottomUpPTA(Module &M, unsigned threads) : module(M), threads(threads) {}
+
+    void run() {
+        signatures = std::make_shared<SignatureIndex>(module);
+        globals = std::make_shared<GlobalInitializers>(module, threads);
+        equivalence = std::make_shared<PointerEquivalence>(module);
+        pointerFree = std::make_shared<PointerFreeFunctions>(module, *equivalence);
+        allocators = std::make_shared<AllocatorIndex>(module);
+        relevance = std::make_shared<TypeRelevance>(module, *equivalence);
+
+        // 先用直接调用构建调用图，间接调用边在每一轮分析中发现
+        for (auto &F: module) {
+            if (F.isDeclaration()) continue;
+            callGraph.addNode(&F);
+            for (auto &BB: F) {
+                for (auto &I: BB) {
+                    auto *call = dyn_cast<CallInst>(&I);
+                    if (!call) continue;
+                    auto *callee = call->getCalledFunction();
+                    if (callee && !callee->isDeclaration())
+                        callGraph.addEdge(&F, callee);
+                }
+            }
+        }
+
+        for (unsigned round = 0;; ++round) {
+            runRound();
+
+            bool grew = false;
+            for (const auto &edge: roundEdges) {
+                grew |= callGraph.addEdge(edge.first, edge.second);
+            }
+            Info << "Bottom-up round " << round << " done, call graph "
+                 << (grew ? "grew" : "is stable") << ". \n";
+            if (!grew) break;
+            if (round >= MaxRounds) {
+                Warning << "Indirect call edges did not stabilize, giving up. \n";
+                break;
+            }
+        }
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return roundResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return roundCallResult;
+    }
+
+private:
+    static const unsigned MaxRounds = 32;
+
+    Module &module;
+    unsigned threads;
+    CallGraphSCC callGraph;
+    SummaryTable table;
+    std::shared_ptr<const SignatureIndex> signatures;
+    std::shared_ptr<const GlobalInitializers> globals;
+    std::shared_ptr<const PointerEquivalence> equivalence;
+    std::shared_ptr<const PointerFreeFunctions> pointerFree;
+    std::shared_ptr<const AllocatorIndex> allocators;
+    std::shared_ptr<const TypeRelevance> relevance;
+
+    std::mutex mtx;   // 保护下面这些每轮的汇总结果和SCC任务的调度状态
+    DataflowResult<PTAInfo>::Type roundResult;
+    std::map<unsigned, std::set<std::string>> roundCallResult;
+    std::set<std::pair<Function *, Function *>> roundEdges;
+
+    ///
+    /// The summaries of one SCC, resumable: the position in the SCC iteration
+    /// and, through the visitor's summary frame, in the member's dataflow.
+    ///
+    struct SCCTask {
+        const std::vector<Function *> *members;
+        bool recursive;
+        DataflowResult<PTAInfo>::Type result;
+        std::unique_ptr<PTAVisitor> visitor;
+        std::map<Function *, PTASummary> summaries;
+        unsigned iter = 0;
+        size_t member = 0;
+        bool started = false;                  // members[member]的summary已经开始了
+        bool changed = false;
+
+        bool published = false;
+        Function *waitingFor = nullptr;        // 挂起时等的callee
+        std::vector<SCCTask *> waiters;        // 等这个SCC发布的任务
+    };
+
+    void runRound() {
+        roundResult.clear();
+        roundCallResult.clear();
+        roundEdges.clear();
+
+        auto sccs = callGraph.sccs();
+        std::vector<std::unique_ptr<SCCTask>> tasks;
+        std::map<Function *, SCCTask *> taskOf;
+        for (auto &members: sccs) {
+            auto task = std::make_unique<SCCTask>();
+            task->members = &members;
+            task->recursive = members.size() > 1 || callGraph.hasEdge(members[0], members[0]);
+            for (auto *f: members) {
+                taskOf[f] = task.get();
+            }
+            tasks.push_back(std::move(task));
+        }
+
+        ThreadPool pool(threads);
+        unsigned suspensions = 0;
+        std::function<void(SCCTask *)> schedule = [&](SCCTask *task) {
+            pool.async([&, task] {
+                bool done = step(task);
+
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!done) {
+                    // 挂起期间callee可能已经发布了
+                    ++suspensions;
+                    SCCTask *callee = taskOf.at(task->waitingFor);
+                    if (callee->published) {
+                        task->waitingFor = nullptr;
+                        schedule(task);
+                    } else {
+                        callee->waiters.push_back(task);
+                    }
+                    return;
+                }
+                task->published = true;
+                for (auto *waiter: task->waiters) {
+                    waiter->waitingFor = nullptr;
+                    schedule(waiter);
+                }
+                task->waiters.clear();
+            });
+        };
+
+        for (auto &task: tasks) {
+            SCCTask *self = task.get();
+            task->visitor = makeVisitor(&task->result);
+            task->visitor->setSummaryGate([&, self](Function *callee) {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!mustWait(taskOf, self, callee))
+                    return false;
+                self->waitingFor = callee;
+                return true;
+            });
+        }
+        // sccs()是逆拓扑序，callee的SCC先进队列
+        for (auto &task: tasks) {
+            schedule(task.get());
+        }
+        pool.wait();
+        Info << "Bottom-up: " << (int) tasks.size() << " SCCs, " << (int) suspensions
+             << " suspended at calls. \n";
+
+        table.nextRound();
+    }
+
+    std::unique_ptr<PTAVisitor> makeVisitor(DataflowResult<PTAInfo>::Type *result) {
+        auto visitor = std::make_unique<PTAVisitor>(result, &table);
+        visitor->setSignatureIndex(signatures);
+        visitor->setGlobalInitializers(globals);
+        visitor->setPointerEquivalence(equivalence);
+        visitor->setPointerFreeFunctions(pointerFree);
+        visitor->setAllocatorIndex(allocators);
+        visitor->setTypeRelevance(relevance);
+        return visitor;
+    }
+
+    /// Whether the summary of task has to wait for callee's SCC to publish:
+    /// not for the own SCC or a published one, and not if the SCCs callee's
+    /// waits for lead back to task. Called with mtx held.
+    static bool mustWait(const std::map<Function *, SCCTask *> &taskOf, const SCCTask *task, Function *callee) {
+        const SCCTask *t = taskOf.at(callee);
+        if (t->published)
+            return false;
+        for (; t != task; t = taskOf.at(t->waitingFor)) {
+            if (!t->waitingFor)
+                return true;
+        }
+        return false;   // 自己的SCC，或者等下去就成环了
+    }
+
+    /// Iterate the members of one SCC until their summaries stop changing,
+    /// then publish them.
+    /// @return false if a member's summary suspended at a call
+    bool step(SCCTask *task) {
+        const auto &members = *task->members;
+        for (;;) {
+            for (; task->member < members.size(); ++task->member) {
+                Function *f = members[task->member];
+                if (!task->started) {
+                    task->visitor->beginSummary(f);
+                    task->started = true;
+                }
+                PTASummary summary;
+                if (!task->visitor->resumeSummary(&summary))
+                    return false;
+                task->started = false;
+                auto it = task->summaries.find(f);
+                if (it == task->summaries.end() || !(it->second == summary)) {
+                    task->summaries[f] = summary;
+                    task->changed = true;
+                }
+            }
+            if (!task->recursive || !task->changed) break;
+            if (task->iter >= MaxRounds) {
+                Warning << "SCC of " << members[0]->getName() << " did not converge, giving up. \n";
+                break;
+            }
+            ++task->iter;
+            task->member = 0;
+            task->changed = false;
+        }
+
+        for (const auto &it: task->summaries) {
+            table.publish(it.first, it.second);
+        }
+
+        auto &result = task->result;
+        auto &visitor = *task->visitor;
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &it: result) {
+            roundResult[it.first] = it.second;
+        }
+        for (const auto &it: visitor.getResults()) {
+            roundCallResult[it.first].insert(it.second.begin(), it.second.end());
+        }
+        for (const auto &it: visitor.getCallGraph().getEdges()) {
+            for (auto *callee: it.second) {
+                roundEdges.insert({it.first, callee});
+            }
+        }
+        return true;
+    }
+};
+
+#endif //BOTTOMUP_H
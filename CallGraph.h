@@ -0,0 +1,159 @@
+/************************************************************************
+ *
+ * @file CallGraph.h
+ *
+ * Resolved call graph and its strongly connected components
+ *
+ ***********************************************************************/
+
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include <llvm/IR/Function.h>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace llvm;
+
+///
+/// Call graph built from the call edges the analysis has resolved so far.
+/// SCCs are computed lazily with an iterative Tarjan, so deep call chains
+/// don't recurse on the native stack.
+///
+class CallGraphSCC {
+public:
+    CallGraphSCC() = default;
+
+    /// @return true if the edge is new
+    bool addEdge(Function *caller, Function *callee) {
+        addNode(caller);
+        addNode(callee);
+        bool inserted = edges[caller].insert(callee).second;
+        if (inserted)
+            dirty = true;
+        return inserted;
+    }
+
+    void addNode(Function *f) {
+        if (edges.find(f) == edges.end()) {
+            edges[f] = std::set<Function *>{};
+            dirty = true;
+        }
+    }
+
+    bool hasEdge(Function *caller, Function *callee) const {
+        auto it = edges.find(caller);
+        return it != edges.end() && it->second.count(callee);
+    }
+
+    const std::set<Function *> &callees(Function *f) {
+        addNode(f);
+        return edges[f];
+    }
+
+    /// SCC index of f, SCCs are numbered in reverse topological order
+    /// (callees before callers).
+    unsigned sccOf(Function *f) {
+        addNode(f);
+        recompute();
+        return sccIndex[f];
+    }
+
+    const std::vector<Function *> &members(unsigned scc) {
+        recompute();
+        return components[scc];
+    }
+
+    /// @return true if f sits on a call cycle (including a self loop)
+    bool isRecursive(Function *f) {
+        unsigned scc = sccOf(f);
+        return components[scc].size() > 1 || hasEdge(f, f);
+    }
+
+    bool inSameSCC(Function *a, Function *b) {
+        return sccOf(a) == sccOf(b);
+    }
+
+    const std::map<Function *, std::set<Function *>> &getEdges() const {
+        return edges;
+    }
+
+    /// All SCCs, callees first.
+    const std::vector<std::vector<Function *>> &sccs() {
+        recompute();
+        return components;
+    }
+
+private:
+    std::map<Function *, std::set<Function *>> edges;
+    std::map<Function *, unsigned> sccIndex;
+    std::vector<std::vector<Function *>> components;
+    bool dirty = true;
+
+    void recompute() {
+        if (!dirty) return;
+        dirty = false;
+        sccIndex.clear();
+        components.clear();
+
+        std::map<Function *, unsigned> index, lowLink;
+        std::set<Function *> onStack;
+        std::vector<Function *> stack;
+        unsigned nextIndex = 0;
+
+        // 显式的DFS栈：(节点, 下一个要访问的后继)
+        typedef std::pair<Function *, std::set<Function *>::const_iterator> Frame;
+
+        for (const auto &it: edges) {
+            Function *root = it.first;
+            if (index.count(root)) continue;
+
+            std::vector<Frame> dfs;
+            index[root] = lowLink[root] = nextIndex++;
+            stack.push_back(root);
+            onStack.insert(root);
+            dfs.emplace_back(root, edges[root].begin());
+
+            while (!dfs.empty()) {
+                Function *node = dfs.back().first;
+                auto &succIt = dfs.back().second;
+
+                if (succIt != edges[node].end()) {
+                    Function *succ = *succIt;
+                    ++succIt;
+                    if (!index.count(succ)) {
+                        index[succ] = lowLink[succ] = nextIndex++;
+                        stack.push_back(succ);
+                        onStack.insert(succ);
+                        dfs.emplace_back(succ, edges[succ].begin());
+                    } else if (onStack.count(succ)) {
+                        lowLink[node] = std::min(lowLink[node], index[succ]);
+                    }
+                    continue;
+                }
+
+                dfs.pop_back();
+                if (!dfs.empty()) {
+                    Function *parent = dfs.back().first;
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+                }
+
+                if (lowLink[node] == index[node]) {
+                    std::vector<Function *> component;
+                    Function *member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        onStack.erase(member);
+                        sccIndex[member] = components.size();
+                        component.push_back(member);
+                    } while (member != node);
+                    components.push_back(component);
+                }
+            }
+        }
+    }
+};
+
+#endif //CALLGRAPH_H
@@ -0,0 +1,510 @@
+/************************************************************************
+ *
+ * @file DemandPTA.h
+ *
+ * Demand-driven resolution of individual call sites
+ *
+ ***********************************************************************/
+
+#ifndef DEMANDPTA_H
+#define DEMANDPTA_H
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "MemoryModel.h"
+#include "PointerEquivalence.h"
+#include "SignatureIndex.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Answers "which functions may this call site call" by exploring only the
+/// value flow the call's operand depends on, backwards from the call.
+///
+/// Internally this is an inclusion-based solver whose constraint graph is
+/// built lazily: a node gets its incoming edges only when something demands
+/// it. Nodes are SSA pointers and memory locations (object, byte offset).
+/// The graph and the solved points-to sets are kept between queries, so a
+/// later query only pays for the part of the program it adds.
+///
+/// Given a PointerEquivalence, code SCCP found unreachable contributes
+/// nothing: its stores, calls and returns, and phi inputs along infeasible
+/// edges. Without one every block counts.
+///
+class DemandResolver {
+public:
+    explicit DemandResolver(Module &M) : module(M), DL(M.getDataLayout()), signatures(M) {}
+
+    /// Call sites matching spec: "line", "line:col", "file:line",
+    /// "file:line:col" or "function:%name". A %name only matches calls that
+    /// have a name in the IR; unnamed ones (printed as %5) are picked by
+    /// line and column instead. When the two last fields are both numbers
+    /// they are read as line:col.
+    std::vector<CallInst *> findCallSites(const std::string &spec) const {
+        std::vector<CallInst *> sites;
+        auto colon = spec.rfind(':');
+        std::string prefix = colon == std::string::npos ? "" : spec.substr(0, colon);
+        std::string suffix = colon == std::string::npos ? spec : spec.substr(colon + 1);
+
+        if (!suffix.empty() && suffix[0] == '%') {
+            Function *F = module.getFunction(prefix);
+            if (!F) return sites;
+            for (auto &BB: *F) {
+                for (auto &I: BB) {
+                    auto *call = dyn_cast<CallInst>(&I);
+                    if (call && call->getName() == suffix.substr(1))
+                        sites.push_back(call);
+                }
+            }
+            return sites;
+        }
+
+        unsigned line, column = 0;
+        if (StringRef(suffix).getAsInteger(10, line)) {
+            Error << "Bad call site query: " << spec << ". \n";
+            return sites;
+        }
+        // "file:line:col"或"line:col"，前一段也是数字时它才是行号
+        colon = prefix.rfind(':');
+        StringRef last = StringRef(prefix).substr(colon == std::string::npos ? 0 : colon + 1);
+        unsigned number;
+        if (!last.empty() && !last.getAsInteger(10, number)) {
+            column = line;
+            line = number;
+            prefix = colon == std::string::npos ? "" : prefix.substr(0, colon);
+        }
+        for (auto &F: module) {
+            for (auto &BB: F) {
+                for (auto &I: BB) {
+                    auto *call = dyn_cast<CallInst>(&I);
+                    if (!call || isa<DbgInfoIntrinsic>(call) || !call->getDebugLoc())
+                        continue;
+                    if (call->getDebugLoc().getLine() != line)
+                        continue;
+                    if (column && call->getDebugLoc().getCol() != column)
+                        continue;
+                    StringRef file = call->getDebugLoc()->getFilename();
+                    if (prefix.empty() || file.endswith(prefix))
+                        sites.push_back(call);
+                }
+            }
+        }
+        return sites;
+    }
+
+    void setPointerEquivalence(std::shared_ptr<const PointerEquivalence> equivalence) {
+        this->equivalence = std::move(equivalence);
+    }
+
+    std::set<Function *> resolve(CallInst *call) {
+        unsigned n = varNode(call->getCalledOperand());
+        demand(n);
+        solve();
+
+        std::set<Function *> targets;
+        for (const auto &loc: nodes[n].pts) {
+            auto *F = dyn_cast<Function>(loc.first);
+            if (F && loc.second == 0 && signatures.mayCall(call, F))
+                targets.insert(F);
+        }
+        return targets;
+    }
+
+    unsigned numNodes() const {
+        return nodes.size();
+    }
+
+private:
+    typedef MemLoc Loc;
+
+    struct Node {
+        std::set<Loc> pts;
+        std::set<std::pair<unsigned, int64_t>> succs;  // (dst, 偏移增量)，拷贝边的增量为0
+        std::vector<unsigned> loads;                   // 以本节点为地址的load结果
+        std::vector<unsigned> stores;                  // 以本节点为地址存进去的值
+        std::vector<CallInst *> calls;                 // 以本节点为被调用操作数的调用
+        Value *var = nullptr;                          // SSA指针节点对应的值
+        Loc loc;                                       // 内存节点对应的位置
+        bool demanded = false;
+    };
+
+    struct MemCpy {
+        unsigned dest;
+        unsigned src;
+        int64_t length;
+    };
+
+    Module &module;
+    const DataLayout &DL;
+    SignatureIndex signatures;
+    std::shared_ptr<const PointerEquivalence> equivalence;
+    std::vector<Node> nodes;
+    std::map<Value *, unsigned> varNodes;
+    std::map<Loc, unsigned> memNodes;
+    std::vector<MemCpy> memCpys;
+    std::set<CallInst *> attachedCalls;
+    std::set<Function *> boundCallers;
+    std::set<GlobalVariable *> seededGlobals;
+    std::set<Value *> watchedObjects;
+    std::map<Value *, std::vector<Instruction *>> storesByObject;  // 地址基于该对象的store和memcpy
+    std::vector<Instruction *> unbasedStores;                      // 地址不基于单个对象的
+    bool storesIndexed = false;
+    bool unbasedHooked = false;
+
+    std::deque<unsigned> demandList;
+    std::deque<unsigned> worklist;
+
+    bool isFeasible(BasicBlock *BB) const {
+        return !equivalence || equivalence->isFeasible(BB);
+    }
+
+    bool isFeasible(BasicBlock *from, BasicBlock *to) const {
+        return !equivalence || equivalence->feasibleEdges(to->getParent()).count({from, to});
+    }
+
+    unsigned varNode(Value *v) {
+        auto it = varNodes.find(v);
+        if (it != varNodes.end()) return it->second;
+        nodes.emplace_back();
+        nodes.back().var = v;
+        return varNodes[v] = nodes.size() - 1;
+    }
+
+    unsigned memNode(const Loc &loc) {
+        auto it = memNodes.find(loc);
+        if (it != memNodes.end()) return it->second;
+        nodes.emplace_back();
+        nodes.back().loc = loc;
+        return memNodes[loc] = nodes.size() - 1;
+    }
+
+    void demand(unsigned n) {
+        if (nodes[n].demanded) return;
+        nodes[n].demanded = true;
+        demandList.push_back(n);
+    }
+
+    void addEdge(unsigned src, unsigned dst, int64_t delta = 0) {
+        demand(src);
+        if (nodes[src].succs.insert({dst, delta}).second && !nodes[src].pts.empty())
+            worklist.push_back(src);
+    }
+
+    bool addPts(unsigned n, const Loc &loc) {
+        if (!nodes[n].pts.insert(loc).second) return false;
+        worklist.push_back(n);
+        return true;
+    }
+
+    void solve() {
+        do {
+            while (!demandList.empty() || !worklist.empty()) {
+                while (!demandList.empty()) {
+                    unsigned n = demandList.front();
+                    demandList.pop_front();
+                    addSources(n);
+                }
+                if (worklist.empty()) break;
+                unsigned n = worklist.front();
+                worklist.pop_front();
+                propagate(n);
+            }
+        } while (applyMemCpys());
+    }
+
+    void propagate(unsigned n) {
+        // 拷贝一份，处理过程中nodes可能扩容
+        std::set<Loc> pts = nodes[n].pts;
+        auto succs = nodes[n].succs;
+        for (const auto &succ: succs) {
+            for (const auto &loc: pts) {
+                addPts(succ.first, fieldAt(loc.first, loc.second + succ.second, DL));
+            }
+        }
+
+        auto loads = nodes[n].loads;
+        auto stores = nodes[n].stores;
+        auto calls = nodes[n].calls;
+        for (const auto &loc: pts) {
+            if (!loads.empty() || !stores.empty()) {
+                unsigned mem = memNode(loc);
+                for (unsigned dst: loads) {
+                    addEdge(mem, dst);
+                }
+                for (unsigned src: stores) {
+                    addEdge(src, mem);
+                }
+            }
+            auto *F = dyn_cast<Function>(loc.first);
+            if (!F || loc.second != 0 || F->isDeclaration()) continue;
+            for (auto *call: calls) {
+                if (signatures.mayCall(call, F))
+                    bindCall(call, F);
+            }
+        }
+    }
+
+    void bindCall(CallInst *call, Function *F) {
+        for (unsigned i = 0, num = call->getNumArgOperands(); i < num && i < F->arg_size(); ++i) {
+            if (call->getArgOperand(i)->getType()->isPointerTy())
+                addEdge(varNode(call->getArgOperand(i)), varNode(F->getArg(i)));
+        }
+        if (!call->getType()->isPointerTy()) return;
+        for (auto &BB: *F) {
+            if (!isFeasible(&BB)) continue;
+            if (auto *ret = dyn_cast<ReturnInst>(BB.getTerminator())) {
+                if (ret->getReturnValue())
+                    addEdge(varNode(ret->getReturnValue()), varNode(call));
+            }
+        }
+    }
+
+    void attachCall(CallInst *call) {
+        if (!attachedCalls.insert(call).second) return;
+        unsigned n = varNode(call->getCalledOperand());
+        nodes[n].calls.push_back(call);
+        demand(n);
+        if (!nodes[n].pts.empty())
+            worklist.push_back(n);
+    }
+
+    /// Incoming edges of a node, added the first time it is demanded.
+    void addSources(unsigned n) {
+        if (nodes[n].var)
+            addVarSources(nodes[n].var, n);
+        else
+            addMemSources(nodes[n].loc);
+    }
+
+    void addVarSources(Value *v, unsigned n) {
+        if (isa<Function>(v) || isa<GlobalVariable>(v) || isa<AllocaInst>(v) || isAllocationCall(v)) {
+            addPts(n, Loc(v, 0));
+        } else if (auto *gep = dyn_cast<GEPOperator>(v)) {
+            addEdge(varNode(gep->getPointerOperand()), n, gepOffset(gep, DL));
+        } else if (auto *cast = dyn_cast<BitCastOperator>(v)) {
+            addEdge(varNode(cast->getOperand(0)), n);
+        } else if (auto *cast = dyn_cast<AddrSpaceCastOperator>(v)) {
+            addEdge(varNode(cast->getOperand(0)), n);
+        } else if (auto *phi = dyn_cast<PHINode>(v)) {
+            for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+                if (isFeasible(phi->getIncomingBlock(i), phi->getParent()))
+                    addEdge(varNode(phi->getIncomingValue(i)), n);
+            }
+        } else if (auto *select = dyn_cast<SelectInst>(v)) {
+            addEdge(varNode(select->getTrueValue()), n);
+            addEdge(varNode(select->getFalseValue()), n);
+        } else if (auto *load = dyn_cast<LoadInst>(v)) {
+            unsigned ptr = varNode(load->getPointerOperand());
+            nodes[ptr].loads.push_back(n);
+            demand(ptr);
+            if (!nodes[ptr].pts.empty())
+                worklist.push_back(ptr);
+        } else if (auto *arg = dyn_cast<Argument>(v)) {
+            bindCallers(arg->getParent());
+        } else if (auto *call = dyn_cast<CallInst>(v)) {
+            attachCall(call);
+        }
+    }
+
+    /// Every call that may call F binds its actuals to F's formals: the
+    /// direct calls, and for an address-taken F the indirect calls whose
+    /// signature matches.
+    void bindCallers(Function *F) {
+        if (!boundCallers.insert(F).second) return;
+        for (auto &G: module) {
+            for (auto &BB: G) {
+                if (!isFeasible(&BB)) continue;
+                for (auto &I: BB) {
+                    auto *call = dyn_cast<CallInst>(&I);
+                    if (!call || isa<IntrinsicInst>(call)) continue;
+                    Value *callee = call->getCalledOperand()->stripPointerCasts();
+                    if (callee == F || (!isa<Function>(callee) && signatures.mayCall(call, F)))
+                        attachCall(call);
+                }
+            }
+        }
+    }
+
+    void addMemSources(const Loc &loc) {
+        watchObject(loc.first);
+    }
+
+    /// Hook up the stores and memcpys that may write obj: those whose address
+    /// is obj itself plus constant GEPs and casts, and once obj's address
+    /// escapes into other pointers, those whose address is based on no single
+    /// object. Only the address operands get demanded; the stored values are
+    /// pulled in once an address is known to hit a demanded location.
+    bool watchObject(Value *obj) {
+        if (!watchedObjects.insert(obj).second) return false;
+        if (auto *G = dyn_cast<GlobalVariable>(obj))
+            seedInitializer(G);
+        indexStores();
+        for (auto *I: storesByObject[obj]) {
+            hookStore(I);
+        }
+        if (!unbasedHooked && addressEscapes(obj)) {
+            unbasedHooked = true;
+            for (auto *I: unbasedStores) {
+                hookStore(I);
+            }
+        }
+        return true;
+    }
+
+    /// Group the module's pointer stores and memcpys by the object their
+    /// address is based on, once.
+    void indexStores() {
+        if (storesIndexed) return;
+        storesIndexed = true;
+        for (auto &F: module) {
+            for (auto &BB: F) {
+                if (!isFeasible(&BB)) continue;
+                for (auto &I: BB) {
+                    Value *dest;
+                    if (auto *store = dyn_cast<StoreInst>(&I)) {
+                        if (!store->getValueOperand()->getType()->isPointerTy()) continue;
+                        dest = store->getPointerOperand();
+                    } else if (auto *memCpy = dyn_cast<MemTransferInst>(&I)) {
+                        dest = memCpy->getRawDest();
+                    } else {
+                        continue;
+                    }
+                    if (Value *base = baseObject(dest))
+                        storesByObject[base].push_back(&I);
+                    else
+                        unbasedStores.push_back(&I);
+                }
+            }
+        }
+    }
+
+    void hookStore(Instruction *I) {
+        if (auto *store = dyn_cast<StoreInst>(I)) {
+            unsigned ptr = varNode(store->getPointerOperand());
+            unsigned val = varNode(store->getValueOperand());
+            nodes[ptr].stores.push_back(val);
+            demand(ptr);
+            if (!nodes[ptr].pts.empty())
+                worklist.push_back(ptr);
+        } else if (auto *memCpy = dyn_cast<MemTransferInst>(I)) {
+            auto *len = dyn_cast<ConstantInt>(memCpy->getLength());
+            MemCpy mc{varNode(memCpy->getRawDest()), varNode(memCpy->getRawSource()),
+                      len ? (int64_t) len->getZExtValue() : INT64_MAX};
+            demand(mc.dest);
+            demand(mc.src);
+            memCpys.push_back(mc);
+        }
+    }
+
+    /// The object ptr points into when that follows from ptr alone, i.e.
+    /// ptr is an object plus GEPs and casts; nullptr otherwise.
+    static Value *baseObject(Value *ptr) {
+        while (true) {
+            if (auto *gep = dyn_cast<GEPOperator>(ptr))
+                ptr = gep->getPointerOperand();
+            else if (isa<BitCastOperator>(ptr) || isa<AddrSpaceCastOperator>(ptr))
+                ptr = cast<Operator>(ptr)->getOperand(0);
+            else
+                break;
+        }
+        if (isa<GlobalVariable>(ptr) || isa<AllocaInst>(ptr) || isAllocationCall(ptr))
+            return ptr;
+        return nullptr;
+    }
+
+    /// Whether obj's address may flow into a pointer that baseObject cannot
+    /// trace back to obj: anything but loads, stores, memory intrinsics and
+    /// compares through GEPs and casts of obj.
+    static bool addressEscapes(Value *obj) {
+        std::vector<Value *> worklist{obj};
+        std::set<Value *> visited{obj};
+        while (!worklist.empty()) {
+            Value *v = worklist.back();
+            worklist.pop_back();
+            for (User *user: v->users()) {
+                if (isa<GEPOperator>(user) || isa<BitCastOperator>(user) || isa<AddrSpaceCastOperator>(user)) {
+                    if (visited.insert(user).second)
+                        worklist.push_back(user);
+                } else if (auto *store = dyn_cast<StoreInst>(user)) {
+                    if (store->getValueOperand() == v) return true;
+                } else if (auto *II = dyn_cast<IntrinsicInst>(user)) {
+                    if (!isa<MemIntrinsic>(II) && !isa<DbgInfoIntrinsic>(II) && !II->isLifetimeStartOrEnd())
+                        return true;
+                } else if (!isa<LoadInst>(user) && !isa<ICmpInst>(user)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void seedInitializer(GlobalVariable *G) {
+        if (!seededGlobals.insert(G).second || !G->hasInitializer()) return;
+        seedConstant(G, G->getInitializer(), 0);
+    }
+
+    void seedConstant(GlobalVariable *G, Constant *C, int64_t offset) {
+        if (!C) return;
+        if (C->getType()->isPointerTy()) {
+            if (!C->isNullValue() && !isa<UndefValue>(C))
+                addEdge(varNode(C), memNode(Loc(G, offset)));
+        } else if (auto *st = dyn_cast<StructType>(C->getType())) {
+            const StructLayout *layout = DL.getStructLayout(st);
+            for (unsigned i = 0; i < st->getNumElements(); ++i) {
+                seedConstant(G, C->getAggregateElement(i), offset + layout->getElementOffset(i));
+            }
+        } else if (auto *at = dyn_cast<ArrayType>(C->getType())) {
+            // 数组所有元素合并到0号元素上
+            for (unsigned i = 0; i < at->getNumElements(); ++i) {
+                seedConstant(G, C->getAggregateElement(i), offset);
+            }
+        }
+    }
+
+    /// memcpy(dest, src, len) copies every solved location of the source
+    /// range to the same offset of the destination range.
+    bool applyMemCpys() {
+        bool changed = false;
+        // 接上源对象的store可能往memCpys里添加，按下标遍历
+        for (size_t i = 0; i < memCpys.size(); ++i) {
+            const MemCpy mc = memCpys[i];
+            for (const auto &s: std::set<Loc>(nodes[mc.src].pts)) {
+                // 源对象自己的store也要接上，不然它还没有内存节点可拷
+                changed |= watchObject(s.first);
+            }
+            for (const auto &d: std::set<Loc>(nodes[mc.dest].pts)) {
+                for (const auto &s: std::set<Loc>(nodes[mc.src].pts)) {
+                    std::vector<std::pair<Loc, unsigned>> inRange;
+                    for (auto it = memNodes.lower_bound(Loc(s.first, s.second));
+                         it != memNodes.end() && it->first.first == s.first &&
+                         it->first.second - s.second < mc.length; ++it) {
+                        inRange.push_back(*it);
+                    }
+                    for (const auto &it: inRange) {
+                        unsigned dst = memNode(fieldAt(d.first, d.second + it.first.second - s.second, DL));
+                        if (!nodes[it.second].succs.count({dst, 0})) {
+                            addEdge(it.second, dst);
+                            demand(dst);
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+};
+
+#endif //DEMANDPTA_H
@@ -0,0 +1,121 @@
+/************************************************************************
+ *
+ * @file EntryPoints.h
+ *
+ * Entry-point discovery and concurrent analysis of every root
+ *
+ ***********************************************************************/
+
+#ifndef ENTRYPOINTS_H
+#define ENTRYPOINTS_H
+
+#include <llvm/IR/Module.h>
+#include <memory>
+
+#include "GlobalInitializers.h"
+#include "PTA.h"
+#include "PointerEquivalence.h"
+#include "PointerFree.h"
+#include "SignatureIndex.h"
+#include "TypeRelevance.h"
+#include "ThreadPool.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Functions the analysis has to start from: main, every externally visible
+/// definition and every function whose address is taken (callbacks). main
+/// comes first, the rest keep module order.
+///
+inline std::vector<Function *> discoverEntryPoints(Module &M) {
+    std::vector<Function *> roots;
+    Function *mainFunc = M.getFunction("main");
+    if (mainFunc && !mainFunc->isDeclaration())
+        roots.push_back(mainFunc);
+
+    for (auto &F: M) {
+        if (F.isDeclaration() || F.isIntrinsic() || &F == mainFunc)
+            continue;
+        if (!F.hasLocalLinkage() || F.hasAddressTaken())
+            roots.push_back(&F);
+    }
+    return roots;
+}
+
+///
+/// Analyzes each entry point top-down as an independent task. Every task owns
+/// its visitor, and the per-root results are merged in root order at the end
+/// so the output doesn't depend on scheduling.
+///
+class MultiEntryPTA {
+public:
+    MultiEntryPTA(Module &M, unsigned threads) : module(M), threads(threads) {}
+
+    void run() {
+        auto roots = discoverEntryPoints(module);
+        Info << "Analyzing " << (int) roots.size() << " entry points. \n";
+
+        auto signatures = std::make_shared<SignatureIndex>(module);
+        auto globals = std::make_shared<GlobalInitializers>(module, threads);
+        auto equivalence = std::make_shared<PointerEquivalence>(module);
+        auto pointerFree = std::make_shared<PointerFreeFunctions>(module, *equivalence);
+        auto allocators = std::make_shared<AllocatorIndex>(module);
+        auto relevance = std::make_shared<TypeRelevance>(module, *equivalence);
+        std::vector<DataflowResult<PTAInfo>::Type> results(roots.size());
+        std::vector<std::map<unsigned, std::set<std::string>>> callResults(roots.size());
+        {
+            ThreadPool pool(threads);
+            for (unsigned i = 0; i < roots.size(); ++i) {
+                pool.async([&, i] {
+                    PTAVisitor visitor(&results[i]);
+                    visitor.setSignatureIndex(signatures);
+                    visitor.setGlobalInitializers(globals);
+                    visitor.setPointerEquivalence(equivalence);
+                    visitor.setPointerFreeFunctions(pointerFree);
+                    visitor.setAllocatorIndex(allocators);
+                    visitor.setTypeRelevance(relevance);
+                    visitor.analyzeFunction(roots[i], rootEntryState(roots[i]));
+                    callResults[i] = visitor.getResults();
+                });
+            }
+            pool.wait();
+        }
+
+        for (unsigned i = 0; i < roots.size(); ++i) {
+            for (auto &it: results[i]) {
+                dfResult[it.first] = it.second;
+            }
+            for (const auto &it: callResults[i]) {
+                callResult[it.first].insert(it.second.begin(), it.second.end());
+            }
+        }
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    Module &module;
+    unsigned threads;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+
+    /// Nothing is known about the callers of a root, so its pointer formals
+    /// start out pointing nowhere.
+    static PTAInfo rootEntryState(Function *root) {
+        PTAInfo entry{};
+        for (auto &arg: root->args()) {
+            if (arg.getType()->isPointerTy())
+                entry.setPointerAndPTS(&arg, std::set<MemLoc>{});
+        }
+        return entry;
+    }
+};
+
+#endif //ENTRYPOINTS_H
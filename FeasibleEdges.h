@@ -0,0 +1,227 @@
+/************************************************************************
+ *
+ * @file FeasibleEdges.h
+ *
+ * Sparse conditional constant propagation, for the CFG edges a function
+ * can actually take
+ *
+ ***********************************************************************/
+
+#ifndef FEASIBLEEDGES_H
+#define FEASIBLEEDGES_H
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Wegman-Zadeck SCCP over one function's integer SSA values. A block is
+/// visited only once an edge into it is feasible, and a conditional branch
+/// or switch only makes the edges its condition allows feasible, so code
+/// guarded by a condition that folds to a constant (a configuration flag, a
+/// comparison of known values) is never reached. Arguments, loads and calls
+/// are overdefined; undef is too, rather than any value that suits.
+///
+/// The flow-sensitive analysis follows only the feasible edges, see
+/// PTAVisitor::runFrame.
+///
+class FeasibleEdges {
+public:
+    typedef std::set<std::pair<BasicBlock *, BasicBlock *>> Edges;
+
+    explicit FeasibleEdges(Function *fn) {
+        markExecutable(&fn->getEntryBlock());
+        while (!blockWorklist.empty() || !valueWorklist.empty()) {
+            while (!valueWorklist.empty()) {
+                auto *I = valueWorklist.back();
+                valueWorklist.pop_back();
+                if (executable.count(I->getParent()))
+                    visit(I);
+            }
+            if (blockWorklist.empty()) break;
+            BasicBlock *BB = blockWorklist.back();
+            blockWorklist.pop_back();
+            for (auto &I: *BB) {
+                visit(&I);
+            }
+        }
+
+        Edges all;
+        for (auto &BB: *fn) {
+            for (auto *succ: successors(&BB)) {
+                all.insert({&BB, succ});
+            }
+        }
+        if (edges.size() < all.size())
+            Info << "SCCP: " << (int) (all.size() - edges.size()) << " of " << (int) all.size() << " edges of "
+                 << fn->getName() << " infeasible. \n";
+    }
+
+    const Edges &getEdges() const {
+        return edges;
+    }
+
+private:
+    /// Lattice value: Unknown (no information yet) > Constant > Overdefined.
+    struct Lattice {
+        enum Kind { Unknown, Constant, Overdefined } kind;
+        ConstantInt *value;
+
+        bool operator!=(const Lattice &rhs) const {
+            return kind != rhs.kind || value != rhs.value;
+        }
+    };
+
+    std::set<BasicBlock *> executable;
+    Edges edges;
+    std::map<Value *, Lattice> values;
+    std::vector<BasicBlock *> blockWorklist;
+    std::vector<Instruction *> valueWorklist;
+
+    static Lattice overdefined() {
+        return Lattice{Lattice::Overdefined, nullptr};
+    }
+
+    Lattice get(Value *v) const {
+        if (auto *C = dyn_cast<ConstantInt>(v))
+            return Lattice{Lattice::Constant, C};
+        if (isa<Constant>(v) || !v->getType()->isIntegerTy() || !isa<Instruction>(v))
+            return overdefined();   // 参数和非整数的值不追踪
+        auto it = values.find(v);
+        return it == values.end() ? Lattice{Lattice::Unknown, nullptr} : it->second;
+    }
+
+    /// Lower v to l, which is at or below its current value.
+    void set(Instruction *v, Lattice l) {
+        auto old = get(v);
+        if (l.kind == Lattice::Unknown || old.kind == Lattice::Overdefined || !(old != l)) return;
+        if (old.kind == Lattice::Constant && l.kind == Lattice::Constant)
+            l = overdefined();   // 两个不同的常量
+        values[v] = l;
+        for (auto *user: v->users()) {
+            if (auto *I = dyn_cast<Instruction>(user))
+                valueWorklist.push_back(I);
+        }
+    }
+
+    /// Lattice value of a constant fold result: only integers are tracked.
+    static Lattice folded(Constant *C) {
+        auto *value = dyn_cast_or_null<ConstantInt>(C);
+        return value ? Lattice{Lattice::Constant, value} : overdefined();
+    }
+
+    void markExecutable(BasicBlock *BB) {
+        if (executable.insert(BB).second)
+            blockWorklist.push_back(BB);
+    }
+
+    void markEdge(BasicBlock *from, BasicBlock *to) {
+        if (!edges.insert({from, to}).second) return;
+        if (executable.count(to)) {
+            // 新的可行入边只影响phi
+            for (auto &phi: to->phis()) {
+                valueWorklist.push_back(&phi);
+            }
+        }
+        markExecutable(to);
+    }
+
+    void visit(Instruction *I) {
+        if (auto *br = dyn_cast<BranchInst>(I)) {
+            visitBranch(br);
+        } else if (auto *sw = dyn_cast<SwitchInst>(I)) {
+            visitSwitch(sw);
+        } else if (I->isTerminator()) {
+            for (auto *succ: successors(I->getParent())) {
+                markEdge(I->getParent(), succ);
+            }
+        } else if (!I->getType()->isIntegerTy()) {
+            return;
+        } else if (auto *phi = dyn_cast<PHINode>(I)) {
+            visitPhi(phi);
+        } else if (auto *select = dyn_cast<SelectInst>(I)) {
+            auto cond = get(select->getCondition());
+            if (cond.kind == Lattice::Unknown) return;
+            if (cond.kind == Lattice::Constant)
+                set(I, get(cond.value->isOne() ? select->getTrueValue() : select->getFalseValue()));
+            else
+                set(I, meet(get(select->getTrueValue()), get(select->getFalseValue())));
+        } else if (isa<BinaryOperator>(I) || isa<CmpInst>(I) || isa<CastInst>(I)) {
+            visitOperator(I);
+        } else {
+            set(I, overdefined());
+        }
+    }
+
+    static Lattice meet(Lattice a, Lattice b) {
+        if (a.kind == Lattice::Unknown) return b;
+        if (b.kind == Lattice::Unknown) return a;
+        if (a.kind == Lattice::Constant && b.kind == Lattice::Constant && a.value == b.value) return a;
+        return overdefined();
+    }
+
+    void visitPhi(PHINode *phi) {
+        Lattice result{Lattice::Unknown, nullptr};
+        for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+            if (edges.count({phi->getIncomingBlock(i), phi->getParent()}))
+                result = meet(result, get(phi->getIncomingValue(i)));
+        }
+        if (result.kind != Lattice::Unknown)
+            set(phi, result);
+    }
+
+    void visitOperator(Instruction *I) {
+        std::vector<Constant *> operands;
+        for (Value *op: I->operand_values()) {
+            auto l = get(op);
+            if (l.kind == Lattice::Unknown) return;
+            if (l.kind == Lattice::Overdefined) {
+                set(I, overdefined());
+                return;
+            }
+            operands.push_back(l.value);
+        }
+        if (auto *cmp = dyn_cast<CmpInst>(I))
+            set(I, folded(ConstantExpr::getCompare(cmp->getPredicate(), operands[0], operands[1])));
+        else if (auto *cast = dyn_cast<CastInst>(I))
+            set(I, folded(ConstantExpr::getCast(cast->getOpcode(), operands[0], I->getType())));
+        else
+            set(I, folded(ConstantExpr::get(I->getOpcode(), operands[0], operands[1])));
+    }
+
+    void visitBranch(BranchInst *br) {
+        BasicBlock *BB = br->getParent();
+        if (br->isUnconditional()) {
+            markEdge(BB, br->getSuccessor(0));
+            return;
+        }
+        auto cond = get(br->getCondition());
+        if (cond.kind == Lattice::Constant) {
+            markEdge(BB, br->getSuccessor(cond.value->isOne() ? 0 : 1));
+        } else if (cond.kind == Lattice::Overdefined) {
+            markEdge(BB, br->getSuccessor(0));
+            markEdge(BB, br->getSuccessor(1));
+        }
+    }
+
+    void visitSwitch(SwitchInst *sw) {
+        BasicBlock *BB = sw->getParent();
+        auto cond = get(sw->getCondition());
+        if (cond.kind == Lattice::Constant) {
+            markEdge(BB, sw->findCaseValue(cond.value)->getCaseSuccessor());
+        } else if (cond.kind == Lattice::Overdefined) {
+            for (auto *succ: successors(BB)) {
+                markEdge(BB, succ);
+            }
+        }
+    }
+};
+
+#endif //FEASIBLEEDGES_H
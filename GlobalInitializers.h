@@ -0,0 +1,99 @@
+/************************************************************************
+ *
+ * @file GlobalInitializers.h
+ *
+ * Points-to facts of the global variable initializers
+ *
+ ***********************************************************************/
+
+#ifndef GLOBALINITIALIZERS_H
+#define GLOBALINITIALIZERS_H
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Module.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "MemoryModel.h"
+#include "ThreadPool.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// What every global holds before the program runs: dispatch tables, ops
+/// structs and plain function pointer globals. Each global's initializer is
+/// walked once, the globals in parallel, into field-sensitive facts that the
+/// analysis reads as the base of every state: a location the state never
+/// wrote still holds its initial contents.
+///
+class GlobalInitializers {
+public:
+    /// @threads number of workers, 0 for the hardware concurrency
+    GlobalInitializers(Module &M, unsigned threads) {
+        std::vector<GlobalVariable *> globals;
+        for (auto &G: M.globals()) {
+            if (G.hasInitializer())
+                globals.push_back(&G);
+        }
+
+        std::vector<std::vector<std::pair<MemLoc, std::set<MemLoc>>>> seeded(globals.size());
+        {
+            ThreadPool pool(threads);
+            for (unsigned i = 0; i < globals.size(); ++i) {
+                pool.async([&, i] {
+                    // 结构体布局是懒计算并缓存的，每个线程用自己的DataLayout
+                    DataLayout DL(M.getDataLayout());
+                    seed(globals[i], globals[i]->getInitializer(), 0, DL, seeded[i]);
+                });
+            }
+            pool.wait();
+        }
+
+        for (const auto &fields: seeded) {
+            for (const auto &field: fields) {
+                facts[field.first].insert(field.second.begin(), field.second.end());
+            }
+        }
+        Info << "Seeded " << (int) facts.size() << " pointer fields from " << (int) globals.size()
+             << " global initializers. \n";
+    }
+
+    /// Initial contents of loc, nullptr if it holds no pointer.
+    const std::set<MemLoc> *lookup(const MemLoc &loc) const {
+        auto it = facts.find(loc);
+        return it == facts.end() ? nullptr : &it->second;
+    }
+
+    const std::map<MemLoc, std::set<MemLoc>> &getFacts() const {
+        return facts;
+    }
+
+private:
+    std::map<MemLoc, std::set<MemLoc>> facts;
+
+    /// Only reads operands, never asks for constants that may not exist yet:
+    /// creating constants isn't safe off the main thread.
+    static void seed(GlobalVariable *G, Constant *C, int64_t offset, const DataLayout &DL,
+                     std::vector<std::pair<MemLoc, std::set<MemLoc>>> &out) {
+        if (C->getType()->isPointerTy()) {
+            auto pts = constantPts(C, DL);
+            if (!pts.empty())
+                out.emplace_back(MemLoc(G, offset), pts);
+        } else if (auto *cs = dyn_cast<ConstantStruct>(C)) {
+            const StructLayout *layout = DL.getStructLayout(cs->getType());
+            for (unsigned i = 0; i < cs->getNumOperands(); ++i) {
+                seed(G, cs->getOperand(i), offset + layout->getElementOffset(i), DL, out);
+            }
+        } else if (auto *ca = dyn_cast<ConstantArray>(C)) {
+            // 数组所有元素合并到0号元素上
+            for (unsigned i = 0; i < ca->getNumOperands(); ++i) {
+                seed(G, ca->getOperand(i), offset, DL, out);
+            }
+        }
+    }
+};
+
+#endif //GLOBALINITIALIZERS_H
@@ -0,0 +1,75 @@
+/************************************************************************
+ *
+ * @file HybridPTA.h
+ *
+ * Hybrid mode: the allocas are tracked flow-sensitively, globals and heap
+ * objects in one flow-insensitive store
+ *
+ ***********************************************************************/
+
+#ifndef HYBRIDPTA_H
+#define HYBRIDPTA_H
+
+#include <llvm/IR/Module.h>
+#include <chrono>
+#include <memory>
+
+#include "GlobalInitializers.h"
+#include "PTA.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Runs the PTAVisitor from the entry function with a flow-insensitive heap:
+/// strong updates, and so most of the precision, come from the allocas and
+/// the SSA values, while globals and heap objects are only ever weakly
+/// updated anyway. Their contents are kept once for the whole module instead
+/// of in every block's state.
+///
+/// Since a load reads the heap as it is when the load is evaluated, the
+/// analysis is rerun from the entry until a round leaves the heap unchanged.
+///
+class HybridPTA {
+public:
+    HybridPTA(Module &M, Function *entry, unsigned threads) : module(M), entry(entry), threads(threads) {}
+
+    void run() {
+        auto start = std::chrono::steady_clock::now();
+        auto heap = std::make_shared<MemoryStore>();
+        PTAVisitor visitor(&dfResult);
+        visitor.setGlobalInitializers(std::make_shared<GlobalInitializers>(module, threads));
+        visitor.setFlowInsensitiveHeap(heap);
+
+        unsigned rounds = 0;
+        MemoryStore before;
+        do {
+            before = *heap;
+            visitor.analyzeFunction(entry, PTAInfo{});
+            ++rounds;
+        } while (*heap != before);
+
+        callResult = visitor.getResults();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "Hybrid: " << (int) heap->size() << " heap locations, " << (int) rounds
+             << " rounds, solved in " << (int) us << "us. \n";
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    Module &module;
+    Function *entry;
+    unsigned threads;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+};
+
+#endif //HYBRIDPTA_H
@@ -31,7 +31,7 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "Liveness.h"
-#include "PTA.h"
+#include "PTAPass.h"
 #include "utils.h"
 
 using namespace llvm;
@@ -92,6 +92,8 @@ int main(int argc, char **argv) {
     // Parse the command line to read the Inputfilename
     cl::ParseCommandLineOptions(argc, argv,
                                 "FuncPtrPass \n My first LLVM too which does not do much.\n");
+    if (!checkPTAOptions())
+        return 1;
 
 
     // Load the input module
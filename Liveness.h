@@ -12,6 +12,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
 #include <llvm/IR/Function.h>
 #include <llvm/Pass.h>
 #include <llvm/Support/raw_ostream.h>
@@ -90,5 +93,4 @@ public:
     }
 };
 
-
-
+#endif //LIVENESS_H
@@ -0,0 +1,301 @@
+/************************************************************************
+ *
+ * @file MemoryModel.h
+ *
+ * Abstract objects and byte-offset fields shared by the analyses
+ *
+ ***********************************************************************/
+
+#ifndef MEMORYMODEL_H
+#define MEMORYMODEL_H
+
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/GetElementPtrTypeIterator.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+
+///
+/// An abstract memory location: the object (alloca, global, heap allocation
+/// site or function) and a byte offset into it. Fields of a struct are
+/// distinct locations of the same object.
+///
+typedef std::pair<Value *, int64_t> MemLoc;
+
+///
+/// Byte offset a GEP adds to its base pointer. Array indices and pointer
+/// arithmetic are ignored, so all elements of an array share the location
+/// of the first one (the same way the global initializers are seeded), no
+/// matter whether the element is reached through the array or a decayed
+/// pointer. Constant arithmetic on i8 pointers is how optimized IR addresses
+/// struct fields, so that does count.
+///
+inline int64_t gepOffset(GEPOperator *gep, const DataLayout &DL) {
+    int64_t offset = 0;
+    for (auto gti = gep_type_begin(gep), gte = gep_type_end(gep); gti != gte; ++gti) {
+        auto *idx = dyn_cast<ConstantInt>(gti.getOperand());
+        if (StructType *st = gti.getStructTypeOrNull()) {
+            offset += DL.getStructLayout(st)->getElementOffset(idx->getZExtValue());
+        } else if (idx && gti.getIndexedType()->isIntegerTy(8)) {
+            offset += idx->getSExtValue();
+        }
+    }
+    return offset;
+}
+
+/// Objects of unknown size (heap objects of wrappers, functions, and formals
+/// and placeholders of summaries that point to bytes) have their offsets
+/// wrapped at this many bytes.
+static const int64_t UnknownObjectSize = 256;
+
+/// The type obj's fields are laid out by, nullptr if unknown. A formal or a
+/// placeholder (the load that read it) of a summary stands for the object
+/// it points to, of the type it is declared to point to, and an allocation
+/// site has the type its result is cast to. A byte type doesn't count: a
+/// void * or char * says nothing about the object.
+inline Type *objectType(Value *obj) {
+    if (auto *alloca = dyn_cast<AllocaInst>(obj))
+        return alloca->getAllocatedType();
+    if (auto *G = dyn_cast<GlobalVariable>(obj))
+        return G->getValueType();
+    Value *typed = obj;
+    if (isa<CallInst>(obj))
+        typed = obj->hasOneUse() ? dyn_cast<BitCastInst>(obj->user_back()) : nullptr;
+    else if (!isa<Argument>(obj) && !isa<LoadInst>(obj))
+        typed = nullptr;
+    auto *type = typed ? dyn_cast<PointerType>(typed->getType()) : nullptr;
+    if (type && !type->getElementType()->isIntegerTy(8))
+        return type->getElementType();
+    return nullptr;
+}
+
+/// Bytes of obj its field offsets range over. Arrays count as their first
+/// element, like in gepOffset; a malloc/calloc/realloc site of constant size
+/// has that size.
+inline int64_t objectSize(Value *obj, const DataLayout &DL) {
+    Type *type = isa<CallInst>(obj) ? nullptr : objectType(obj);
+    if (auto *call = dyn_cast<CallInst>(obj)) {
+        auto *callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+        if (callee && callee->isDeclaration() && call->getNumArgOperands() > 0) {
+            StringRef name = callee->getName();
+            unsigned sizeArg = name == "malloc" ? 0 : name == "calloc" || name == "realloc" ? 1 : ~0u;
+            auto *size = sizeArg < call->getNumArgOperands() ? dyn_cast<ConstantInt>(call->getArgOperand(sizeArg))
+                                                             : nullptr;
+            if (size && size->getSExtValue() > 0)
+                return size->getSExtValue();
+        }
+    }
+    while (type && type->isArrayTy()) {
+        type = type->getArrayElementType();
+    }
+    if (!type || !type->isSized())
+        return UnknownObjectSize;
+    auto size = (int64_t) DL.getTypeAllocSize(type);
+    return size > 0 ? size : 1;
+}
+
+/// Whether type has an array anywhere in it, whose elements share a location.
+inline bool containsArray(Type *type) {
+    if (type->isArrayTy() || type->isVectorTy())
+        return true;
+    if (auto *st = dyn_cast<StructType>(type)) {
+        for (auto *element: st->elements()) {
+            if (containsArray(element))
+                return true;
+        }
+    }
+    return false;
+}
+
+/// Whether every location of obj stands for exactly one of its fields: its
+/// type is known, has no arrays and covers the whole object, so no offset
+/// is ever wrapped onto another field.
+inline bool hasExactFields(Value *obj, const DataLayout &DL) {
+    Type *type = objectType(obj);
+    return type && type->isSized() && !containsArray(type) &&
+           (int64_t) DL.getTypeAllocSize(type) == objectSize(obj, DL);
+}
+
+///
+/// The location offset bytes into obj. Offsets are taken modulo the object's
+/// size, so pointer arithmetic that runs past the object (a char * advanced
+/// around a loop) ends up at finitely many locations, while arithmetic that
+/// comes back into the object still finds the exact field.
+///
+inline MemLoc fieldAt(Value *obj, int64_t offset, const DataLayout &DL) {
+    if (offset == 0)
+        return MemLoc(obj, 0);
+    int64_t size = objectSize(obj, DL);
+    offset %= size;
+    return MemLoc(obj, offset < 0 ? offset + size : offset);
+}
+
+inline std::set<MemLoc> shift(const std::set<MemLoc> &pts, int64_t offset, const DataLayout &DL) {
+    std::set<MemLoc> result;
+    for (const auto &loc: pts) {
+        result.insert(fieldAt(loc.first, loc.second + offset, DL));
+    }
+    return result;
+}
+
+/// Locations a pointer constant points to: functions and globals are objects
+/// of their own, GEP and cast expressions over them are evaluated, null and
+/// undef point nowhere.
+inline std::set<MemLoc> constantPts(Constant *C, const DataLayout &DL) {
+    if (isa<Function>(C) || isa<GlobalVariable>(C))
+        return std::set<MemLoc>{MemLoc(C, 0)};
+    if (auto *alias = dyn_cast<GlobalAlias>(C))
+        return constantPts(alias->getAliasee(), DL);
+    if (auto *gep = dyn_cast<GEPOperator>(C))
+        return shift(constantPts(cast<Constant>(gep->getPointerOperand()), DL), gepOffset(gep, DL), DL);
+    if (auto *bitCast = dyn_cast<BitCastOperator>(C))
+        return constantPts(cast<Constant>(bitCast->getOperand(0)), DL);
+    return std::set<MemLoc>{};
+}
+
+/// Wrappers of wrappers are recognized up to this many levels.
+static const unsigned MaxAllocatorWrapperDepth = 3;
+
+/// v doesn't escape the function other than by being returned: every use
+/// is a return, a null check, or a cast or phi whose uses are such as well.
+/// Stored, passed to a call or written through, the object isn't fresh for
+/// the callers anymore.
+inline bool isOnlyReturned(Value *v, std::set<Value *> &visited) {
+    if (!visited.insert(v).second) return true;
+    for (auto *user: v->users()) {
+        if (isa<ReturnInst>(user) || isa<ICmpInst>(user))
+            continue;
+        if (!isa<BitCastInst>(user) && !isa<PHINode>(user) && !isa<SelectInst>(user))
+            return false;
+        if (!isOnlyReturned(user, visited))
+            return false;
+    }
+    return true;
+}
+
+///
+/// F returns a fresh heap object on every path: one of the C allocators, or a
+/// wrapper whose every return value is null or the result of an allocator
+/// call that doesn't escape otherwise.
+///
+inline bool isAllocator(Function *F, unsigned depth = 0) {
+    if (!F) return false;
+    if (F->isDeclaration()) {
+        StringRef name = F->getName();
+        return name == "malloc" || name == "calloc" || name == "realloc";
+    }
+    if (depth >= MaxAllocatorWrapperDepth || !F->getReturnType()->isPointerTy())
+        return false;
+
+    bool returnsFresh = false;
+    for (auto &BB: *F) {
+        auto *ret = dyn_cast<ReturnInst>(BB.getTerminator());
+        if (!ret) continue;
+
+        std::vector<Value *> worklist{ret->getReturnValue()};
+        std::set<Value *> visited;
+        while (!worklist.empty()) {
+            Value *v = worklist.back();
+            worklist.pop_back();
+            if (!visited.insert(v).second || isa<ConstantPointerNull>(v))
+                continue;
+            if (auto *cast = dyn_cast<BitCastInst>(v)) {
+                worklist.push_back(cast->getOperand(0));
+                continue;
+            }
+            if (auto *phi = dyn_cast<PHINode>(v)) {
+                worklist.insert(worklist.end(), phi->incoming_values().begin(), phi->incoming_values().end());
+                continue;
+            }
+
+            auto *call = dyn_cast<CallInst>(v);
+            std::set<Value *> users;
+            if (!call || !isAllocator(dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts()), depth + 1) ||
+                !isOnlyReturned(call, users))
+                return false;
+            returnsFresh = true;
+        }
+    }
+    return returnsFresh;
+}
+
+/// A call that returns a fresh heap object: each such call site is one
+/// abstract heap object.
+inline bool isAllocationCall(Value *v) {
+    auto *call = dyn_cast<CallInst>(v);
+    return call && isAllocator(dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts()));
+}
+
+///
+/// isAllocator of every function of a module, decided once instead of at
+/// every visit of a call site, and which blocks may run more than once in a
+/// run of the program: an allocation site elsewhere stands for a single
+/// object.
+///
+class AllocatorIndex {
+public:
+    explicit AllocatorIndex(Module &M) {
+        for (auto &F: M) {
+            if (isAllocator(&F))
+                allocators.insert(&F);
+            if (F.isDeclaration()) continue;
+            for (auto it = scc_begin(&F); !it.isAtEnd(); ++it) {
+                if (it.hasCycle())
+                    cyclicBlocks.insert(it->begin(), it->end());
+            }
+        }
+        std::map<Function *, bool> once;
+        for (auto &F: M) {
+            if (!F.isDeclaration() && runsOnce(&F, once))
+                onceFunctions.insert(&F);
+        }
+    }
+
+    bool isAllocationCall(Value *v) const {
+        auto *call = dyn_cast<CallInst>(v);
+        return call && allocators.count(dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts()));
+    }
+
+    /// Whether BB is on a cycle of its function's CFG.
+    bool isOnCycle(BasicBlock *BB) const {
+        return cyclicBlocks.count(BB);
+    }
+
+    /// Whether inst runs at most once: it isn't on a cycle of its function's
+    /// CFG, and the function is a root or has a single call site that runs
+    /// at most once itself.
+    bool runsOnce(Instruction *inst) const {
+        return !isOnCycle(inst->getParent()) && onceFunctions.count(inst->getFunction());
+    }
+
+private:
+    std::set<Function *> allocators;
+    std::set<BasicBlock *> cyclicBlocks;
+    std::set<Function *> onceFunctions;
+
+    bool runsOnce(Function *F, std::map<Function *, bool> &once) const {
+        auto it = once.find(F);
+        if (it != once.end())
+            return it->second;
+        once[F] = false;   // 递归调用不止一次
+        bool result = F->use_empty();
+        if (F->hasOneUse()) {
+            auto *call = dyn_cast<CallInst>(F->user_back());
+            if (call && call->getCalledOperand() == F && !isOnCycle(call->getParent()))
+                result = runsOnce(call->getFunction(), once);
+        }
+        return once[F] = result;
+    }
+};
+
+#endif //MEMORYMODEL_H
@@ -23,8 +23,20 @@
 #include <llvm/Pass.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/IR/IntrinsicInst.h>
+#include <functional>
+#include <memory>
+#include <mutex>
 
+#include "CallGraph.h"
 #include "Dataflow.h"
+#include "GlobalInitializers.h"
+#include "Liveness.h"
+#include "MemoryModel.h"
+#include "PointerEquivalence.h"
+#include "PointerFree.h"
+#include "SignatureIndex.h"
+#include "ThreadPool.h"
+#include "TypeRelevance.h"
 #include "utils.h"
 
 using namespace llvm;
@@ -165,10 +177,29 @@ struct PTS {
 */
 
 
+
+/// Contents of the memory locations: allocas, globals and heap objects.
+typedef std::map<MemLoc, std::set<MemLoc>> MemoryStore;
+
+///
+/// The state at a program point: the SSA pointers of the current function's
+/// frame, and the memory store, which is shared copy-on-write between states.
+/// The store is copied on the first write after a state was copied, so the
+/// states of blocks that only read memory, and the callee's entry state,
+/// share their caller's store; two states whose stores are shared compare and
+/// merge their memory for free.
+///
+/// In bottom-up mode a location of the callers that isn't in memory holds
+/// whatever the caller put there, and one in memory holds what the function
+/// wrote, plus the caller's contents if it is also in unwritten: some path
+/// didn't write it, or wrote it weakly.
+///
 struct PTAInfo {
-    std::map<Value *, std::set<Value *>> info;
+    std::map<Value *, std::set<MemLoc>> info;   // 当前栈帧的SSA指针（以及函数的返回值）-> 指向的位置
+    std::shared_ptr<MemoryStore> sharedMem;     // 内存位置 -> 里面存的指针指向的位置，写时复制
+    std::set<MemLoc> unwritten;                 // bottom-up模式：可能还是调用者原来内容的位置
 
-    PTAInfo() : info() {}
+    PTAInfo() : info(), sharedMem() {}
 
     PTAInfo(const PTAInfo &info) = default;
 
@@ -178,17 +209,86 @@ struct PTAInfo {
         return info.find(val) != info.end();
     }
 
-    std::set<Value *> getPTS(Value *p) const {
+    std::set<MemLoc> getPTS(Value *p) const {
         assert(info.find(p) != info.end());
         return info.find(p)->second;
     }
 
-    void setPointerAndPTS(Value *val, std::set<Value *> pts) {
+    void setPointerAndPTS(Value *val, std::set<MemLoc> pts) {
         info[val] = pts;
     }
 
+    const MemoryStore &memory() const {
+        static const MemoryStore empty;
+        return sharedMem ? *sharedMem : empty;
+    }
+
+    /// The store for writing, copied first if another state shares it.
+    MemoryStore &mutableMemory() {
+        if (!sharedMem)
+            sharedMem = std::make_shared<MemoryStore>();
+        else if (sharedMem.use_count() > 1)
+            sharedMem = std::make_shared<MemoryStore>(*sharedMem);
+        return *sharedMem;
+    }
+
+    /// Take over rhs's memory, sharing it.
+    void shareMemory(const PTAInfo &rhs) {
+        sharedMem = rhs.sharedMem;
+    }
+
+    bool hasLocation(const MemLoc &loc) const {
+        return memory().find(loc) != memory().end();
+    }
+
+    /// Contents of loc, empty if nothing was stored there.
+    std::set<MemLoc> load(const MemLoc &loc) const {
+        auto it = memory().find(loc);
+        return it == memory().end() ? std::set<MemLoc>{} : it->second;
+    }
+
+    void store(const MemLoc &loc, std::set<MemLoc> pts) {
+        mutableMemory()[loc] = pts;
+        unwritten.erase(loc);
+    }
+
+    /// Drop whatever is stored in [loc, loc + length) of loc's object.
+    void clear(const MemLoc &loc, int64_t length) {
+        for (auto it = unwritten.lower_bound(loc);
+             it != unwritten.end() && it->first == loc.first && it->second - loc.second < length;) {
+            it = unwritten.erase(it);
+        }
+        auto it = memory().lower_bound(loc);
+        if (it == memory().end() || it->first.first != loc.first || it->first.second - loc.second >= length)
+            return;   // 没有可删的，不必复制
+        auto &mem = mutableMemory();
+        it = mem.lower_bound(loc);
+        while (it != mem.end() && it->first.first == loc.first && it->first.second - loc.second < length) {
+            it = mem.erase(it);
+        }
+    }
+
+    /// Pointwise union, every field is a location of its own.
+    void unionWith(const PTAInfo &rhs) {
+        for (const auto &it: rhs.info) {
+            info[it.first].insert(it.second.begin(), it.second.end());
+        }
+        unwritten.insert(rhs.unwritten.begin(), rhs.unwritten.end());
+        if (sharedMem == rhs.sharedMem || rhs.memory().empty())
+            return;
+        if (memory().empty()) {
+            shareMemory(rhs);
+            return;
+        }
+        auto &mem = mutableMemory();
+        for (const auto &it: rhs.memory()) {
+            mem[it.first].insert(it.second.begin(), it.second.end());
+        }
+    }
+
     bool operator==(const PTAInfo &rhs) const {
-        return info == rhs.info;
+        return info == rhs.info && unwritten == rhs.unwritten &&
+               (sharedMem == rhs.sharedMem || memory() == rhs.memory());
     }
 
 };
@@ -213,99 +313,165 @@ struct PTAInfo {
 //    return out;
 //}
 
-inline raw_ostream &operator<<(raw_ostream &out, const PTAInfo &ptaInfo) {
+///
+/// Memory a summarized function read without knowing its contents: the
+/// locations the load read, and the function's memory at the load. The
+/// function may have written those locations through an alias before, which
+/// only shows once a caller binds both to the same location.
+///
+struct Placeholder {
+    std::set<MemLoc> source;
+    PTAInfo state;   // 只用到内存
+
+    bool operator==(const Placeholder &rhs) const {
+        return source == rhs.source && state == rhs.state;
+    }
+};
+
+///
+/// Entry/exit state of a function that sits on a call cycle, accumulated over
+/// every context it was analyzed in. A call into a function that is already
+/// being analyzed reads this summary instead of re-entering the function.
+///
+/// In bottom-up mode only exit, pending and placeholders are used: exit is
+/// computed with every pointer formal pointing to the formal's own object,
+/// and pending holds the indirect calls that resolve through those formals,
+/// to be resolved again at each caller. Memory the function reads without
+/// knowing its contents is a placeholder object named after the load, mapped
+/// here to the locations that load read and the function's memory then.
+///
+struct PTASummary {
+    PTAInfo entry;
+    PTAInfo exit;
+    std::set<CallInst *> pending;
+    std::map<Value *, Placeholder> placeholders;
+
+    bool operator==(const PTASummary &rhs) const {
+        return entry == rhs.entry && exit == rhs.exit && pending == rhs.pending &&
+               placeholders == rhs.placeholders;
+    }
+};
+
+///
+/// Summaries shared between the bottom-up worker threads. Lookups fall back
+/// to the previous refinement round for callees not yet published in the
+/// current one.
+///
+class SummaryTable {
+public:
+    bool lookup(Function *fn, PTASummary *summary) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = current.find(fn);
+        if (it == current.end()) {
+            it = previous.find(fn);
+            if (it == previous.end())
+                return false;
+        }
+        *summary = it->second;
+        return true;
+    }
+
+    void publish(Function *fn, const PTASummary &summary) {
+        std::lock_guard<std::mutex> lock(mtx);
+        current[fn] = summary;
+    }
+
+    void nextRound() {
+        std::lock_guard<std::mutex> lock(mtx);
+        previous = current;
+        current.clear();
+    }
+
+private:
+    std::mutex mtx;
+    std::map<Function *, PTASummary> current;
+    std::map<Function *, PTASummary> previous;
+};
+
+inline std::string printableName(Value *val) {
     static int valNum = 0;
+    if (!val->hasName()) {
+        ++valNum;
+        val->setName("%" + std::to_string(valNum));
+    }
+    return val->getName();
+}
+
+inline std::string printableName(const MemLoc &loc) {
+    std::string name = printableName(loc.first);
+    if (loc.second != 0)
+        name += "+" + std::to_string(loc.second);
+    return name;
+}
+
+inline raw_ostream &operator<<(raw_ostream &out, const std::set<MemLoc> &pts) {
+    out << "{ ";
+    for (const auto &loc: pts) {
+        out << printableName(loc) << ", ";
+    }
+    out << "}; ";
+    return out;
+}
+
+inline raw_ostream &operator<<(raw_ostream &out, const PTAInfo &ptaInfo) {
     out << "{ ";
     for (const auto &item: ptaInfo.info) {
-        auto ptr = item.first;
-        auto pts = item.second;
-        std::string ptrName = ptr->getName();
-        if (ptrName.empty()) {
-            ++valNum;
-            ptr->setName("%" + std::to_string(valNum));
-            ptrName = ptr->getName();
-        }
-        out << ptrName << " -> { ";
-        for (auto p: pts) {
-            std::string pName = p->getName();
-            if (pName.empty()) {
-                ++valNum;
-                ptr->setName("%" + std::to_string(valNum));
-                pName = p->getName();
-//                pName = std::to_string(p->getValueID());
-            }
-            out << pName << ", ";
-        }
-        out << "}; ";
+        out << printableName(item.first) << " -> " << item.second;
+    }
+    for (const auto &item: ptaInfo.memory()) {
+        out << "[" << printableName(item.first) << "] -> " << item.second;
     }
     out << "  } \n";
     return out;
 }
 
+/// The calls PTAVisitor reports a line for: debug intrinsics and
+/// memcpy/memmove/memset have transfer functions of their own.
+inline bool isReportedCall(CallInst *call) {
+    return !isa<DbgInfoIntrinsic>(call) && !isa<MemTransferInst>(call) && !isa<MemSetInst>(call);
+}
+
+/// Report the call sites of the functions reachable from entry like PTAVisitor
+/// does, with the targets a whole-program analysis resolved for them.
+/// @param targetsOf CallInst * -> std::set<Function *>
+template<typename TargetsOf>
+void reportReachableCalls(Function *entry, TargetsOf targetsOf,
+                          std::map<unsigned, std::set<std::string>> *callResult) {
+    std::set<Function *> reached{entry};
+    std::vector<Function *> worklist{entry};
+    while (!worklist.empty()) {
+        Function *F = worklist.back();
+        worklist.pop_back();
+        for (auto &I: instructions(*F)) {
+            auto *call = dyn_cast<CallInst>(&I);
+            if (!call || !isReportedCall(call)) continue;
+            auto &names = (*callResult)[call->getDebugLoc().getLine()];
+            for (auto *callee: targetsOf(call)) {
+                names.insert(callee->getName());
+                if (!callee->isDeclaration() && reached.insert(callee).second)
+                    worklist.push_back(callee);
+            }
+        }
+    }
+}
+
 
 class PTAVisitor : public DataflowVisitor<struct PTAInfo> {
 public:
     explicit PTAVisitor(DataflowResult<PTAInfo>::Type* res): dfResult(res) {}
 
-    void merge(PTAInfo *dest, const PTAInfo &src) override {
-
-        for (const auto &it: src.info) {
-            auto ptr = it.first;
-            auto srcPTS = it.second;
+    /// Switch to bottom-up mode: calls apply the callees' summaries from table
+    /// (or from the visitor's own summaries for members of the SCC being
+    /// computed) instead of analyzing the callees.
+    PTAVisitor(DataflowResult<PTAInfo>::Type* res, SummaryTable *table)
+            : dfResult(res), summaryTable(table) {}
 
-            if (!dest->hasPointer(ptr)) {  // 如果在dest中不存在这个value
-                dest->setPointerAndPTS(ptr, srcPTS);  // 创建这个value，把src中的pts copy过来。
-            } else {
-                auto destPTS = dest->getPTS(ptr);
-                if (ptr->getType()->isFunctionTy()) {
-                    destPTS.merge(srcPTS);
-                    dest->setPointerAndPTS(ptr, destPTS);
-                    continue;
-                }
-
-                if (ptr->getType()->getPointerElementType()->isStructTy() ||
-                    ptr->getType()->getPointerElementType()->isArrayTy()) { // 如果value 是结构体指针类型
-                    auto destPtr = *(destPTS.begin());
-                    auto srcPtr = *(srcPTS.begin());
-                    if (srcPTS.size() > 1 || destPTS.size() > 1)
-                        Error << "Pts size of struct is more then one! \n";
-                    else if (srcPTS.size() == 1 && destPTS.size() == 1 && destPtr != srcPtr) {
-                        // 找到functionPointer type的Value
-                        auto p = destPtr;
-                        auto q = srcPtr;
-                        while (p->getType()->getPointerElementType()->isStructTy()) {
-                            if (!dest->hasPointer(p))
-                                Error << "Don't have dest pointer.\n";
-                            p = *(dest->getPTS(p).begin());
-                        }
-                        while (q->getType()->getPointerElementType()->isStructTy()) {
-                            if (!dest->hasPointer(q))
-                                Error << "Don't have dest pointer.\n";
-                            q = *(src.getPTS(q).begin());
-                        }
-                        // 合并
-                        auto tmpSet = dest->getPTS(p);
-                        tmpSet.merge(src.getPTS(q));
-                        dest->setPointerAndPTS(p, tmpSet);
-
-                    } else {
-                        std::set<Value *> mergedSet;
-                        std::set_union(srcPTS.begin(), srcPTS.end(), destPTS.begin(), destPTS.end(),
-                                       std::inserter(mergedSet, mergedSet.begin()));
-                        dest->setPointerAndPTS(ptr, mergedSet);
-                    }
-                }
-                else { // 非结构体指针类型
-                    std::set<Value *> mergedSet;
-                    std::set_union(srcPTS.begin(), srcPTS.end(), destPTS.begin(), destPTS.end(),
-                                   std::inserter(mergedSet, mergedSet.begin()));
-                    dest->setPointerAndPTS(ptr, mergedSet);
-                }
-            }
-
-        }
+    void merge(PTAInfo *dest, const PTAInfo &src) override {
+        dest->unionWith(src);
     }
 
+    /// Transfer function of an instruction other than a reported call; those
+    /// are evaluated by runFrame, which may suspend the frame at them.
     void compDFVal(Instruction *inst, PTAInfo *dfVal) override {
         // 不处理调试相关的指令
         if (isa<DbgInfoIntrinsic>(inst)) return;
@@ -314,7 +480,6 @@ public:
 
         // 根据指令的类型去进行相应的处理操作
         if (auto *allocaInst = dyn_cast<AllocaInst>(inst)) {
-            // 好像用不着，嘿嘿
             evalAllocaInst(allocaInst, dfVal);
         } else if (auto *storeInst = dyn_cast<StoreInst>(inst)) {
             evalStoreInst(storeInst, dfVal);
@@ -322,23 +487,33 @@ public:
             evalLoadInst(loadInst, dfVal);
         } else if (auto *getElementPtrInst = dyn_cast<GetElementPtrInst>(inst)) {
             evalGetElementPtrInst(getElementPtrInst, dfVal);
-        } else if (auto *memCpyInst = dyn_cast<MemCpyInst>(inst)) {
-            evalMemCpyInst(memCpyInst, dfVal);
+        } else if (auto *memTransferInst = dyn_cast<MemTransferInst>(inst)) {
+            evalMemTransferInst(memTransferInst, dfVal);
         } else if (auto *bitCastInst = dyn_cast<BitCastInst>(inst)) {
             evalBitCastInst(bitCastInst, dfVal);
         } else if (auto *memSetInst = dyn_cast<MemSetInst>(inst)) {
-            // 捕获但不需要处理，防止它被后面CallInst的处理逻辑捕获
+            evalMemSetInst(memSetInst, dfVal);
         } else if (auto *returnInst = dyn_cast<ReturnInst>(inst)) {
             evalReturnInst(returnInst, dfVal);
-        } else if (auto *callInst = dyn_cast<CallInst>(inst)) {
-            evalCallInst(callInst, dfVal);
         } else if (auto *phiNode = dyn_cast<PHINode>(inst) ) {
             evalPhiNode(phiNode, dfVal);
+        } else if (auto *selectInst = dyn_cast<SelectInst>(inst)) {
+            evalSelectInst(selectInst, dfVal);
         } else {
 //            Debug << "Unhandled instruction: " << inst->getName() << '\n';
         }
     }
 
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return functionCallResult;
+    }
+
+    void addResults(const std::map<unsigned, std::set<std::string>> &results) {
+        for (const auto &result: results) {
+            functionCallResult[result.first].insert(result.second.begin(), result.second.end());
+        }
+    }
+
     void printResults(raw_ostream &out) const {
         for (const auto &result: functionCallResult) {
             out << result.first << " : ";
@@ -353,92 +528,780 @@ public:
         }
     }
 
+    /// Analyze fn starting from entryVal and return its exit state.
+    ///
+    /// Functions on a call cycle are iterated at the head of their SCC (the
+    /// outermost member on the analysis stack) until the summaries of the SCC
+    /// stop changing; a recursive call never re-enters a function in progress.
+    ///
+    /// The callees are analyzed on an explicit stack of frames instead of
+    /// the native one: a call suspends its caller's frame at the call and
+    /// pushes the callee's, whose exit resumes the caller where it stopped.
+    /// Only the parallel callee path still recurses, once per parallel call.
+    PTAInfo analyzeFunction(Function *fn, const PTAInfo &entryVal) {
+        prepareModule(fn->getParent());
+        std::vector<AnalysisFrame> stack;
+        pushFrame(&stack, fn, entryVal);
+        PTAInfo exit;
+        while (!stack.empty()) {
+            if (!runFrame(&stack))
+                continue;   // 压进了callee的栈帧
+            exit = stack.back().exit;
+            callStack.pop_back();
+            stack.pop_back();
+            if (!stack.empty())
+                resumeCall(&stack.back(), exit);
+        }
+        return exit;
+    }
+
+    /// Analyze the candidate callees of a call site on separate threads once
+    /// there are at least minCallees of them.
+    void setParallelCallees(unsigned minCallees, ThreadBudget *budget) {
+        parallelCallees = minCallees;
+        threadBudget = budget;
+    }
+
+    /// Share one signature index between visitors of the same module instead
+    /// of building one per visitor.
+    void setSignatureIndex(std::shared_ptr<const SignatureIndex> index) {
+        signatures = std::move(index);
+    }
+
+    /// Share the pointer equivalence classes between visitors of the same
+    /// module.
+    void setPointerEquivalence(std::shared_ptr<const PointerEquivalence> classes) {
+        equivalence = std::move(classes);
+    }
+
+    /// Share the type-relevance index between visitors of the same module.
+    void setTypeRelevance(std::shared_ptr<const TypeRelevance> index) {
+        relevance = std::move(index);
+    }
+
+    /// Share the pointer-free classification between visitors of the same
+    /// module.
+    void setPointerFreeFunctions(std::shared_ptr<const PointerFreeFunctions> functions) {
+        pointerFree = std::move(functions);
+    }
+
+    /// Share the allocators of the module between visitors.
+    void setAllocatorIndex(std::shared_ptr<const AllocatorIndex> index) {
+        allocators = std::move(index);
+    }
+
+    /// Share the initial contents of the globals between visitors of the
+    /// same module.
+    void setGlobalInitializers(std::shared_ptr<const GlobalInitializers> initializers) {
+        globals = std::move(initializers);
+    }
+
+    /// Hybrid mode: globals and heap objects live in heap, one flow-insensitive
+    /// store shared by every program point and only weakly updated; the states
+    /// keep just the contents of the allocas. A load may have read heap before
+    /// a later store grew it, so the caller reruns the analysis until heap
+    /// stops changing. Not for bottom-up mode. heap is written without a
+    /// lock, so while it is set the callees are analyzed on this thread even
+    /// if setParallelCallees asked otherwise.
+    void setFlowInsensitiveHeap(std::shared_ptr<MemoryStore> store) {
+        heap = std::move(store);
+    }
+
+    /// Bottom-up mode: gate(callee) is asked before a summary of callee is
+    /// applied, and returns true if the summary is still being computed and
+    /// the analysis should wait for it, see resumeSummary.
+    void setSummaryGate(std::function<bool(Function *)> gate) {
+        summaryGate = std::move(gate);
+    }
+
+    /// Compute the bottom-up summary of fn once: every pointer formal points
+    /// to the formal's own object, so the exit state refers to the formals
+    /// symbolically. Doesn't wait for callees, whatever the summary gate says.
+    PTASummary summarizeFunction(Function *fn) {
+        auto gate = std::move(summaryGate);
+        summaryGate = nullptr;
+        beginSummary(fn);
+        PTASummary summary;
+        resumeSummary(&summary);
+        summaryGate = std::move(gate);
+        return summary;
+    }
+
+    /// Start the summary of fn on a frame of its own; resumeSummary runs it.
+    void beginSummary(Function *fn) {
+        prepareModule(fn->getParent());
+        summaryFunction = fn;
+        pendingCalls.clear();
+        placeholders.clear();
+
+        PTAInfo entry{};
+        for (auto &arg: fn->args()) {
+            if (arg.getType()->isPointerTy())
+                entry.setPointerAndPTS(&arg, std::set<MemLoc>{MemLoc(&arg, 0)});
+        }
+        summaryStack.clear();
+        pushFrame(&summaryStack, fn, entry);
+    }
+
+    /// Run the summary begun by beginSummary until it is done, or until the
+    /// summary gate asks it to wait at a call. A suspended summary keeps its
+    /// frame, and calling resumeSummary again continues at that call.
+    /// @return true if the summary is done and set
+    bool resumeSummary(PTASummary *summary) {
+        if (!runFrame(&summaryStack))
+            return false;   // 在等callee的summary
+        Function *fn = summaryStack.back().fn;
+        summary->exit = summaryStack.back().exit;
+        callStack.pop_back();
+        summaryStack.clear();
+
+        dropDeadLocals(fn, &summary->exit);
+        summary->pending = pendingCalls;
+        summary->placeholders = placeholders;
+        summaries[fn] = *summary;
+        return true;
+    }
+
+    /// Call edges resolved so far, including the ones discovered through
+    /// pending calls of callee summaries.
+    CallGraphSCC &getCallGraph() {
+        return callGraph;
+    }
+
 private:
+    static const unsigned MaxSCCIterations = 64;
+
     DataflowResult<PTAInfo>::Type* dfResult;
     std::map<unsigned, std::set<std::string>> functionCallResult;
+    std::shared_ptr<const DataLayout> dataLayout;      // 计算字段的字节偏移，结构体布局的缓存不能跨线程共享
+    std::shared_ptr<const SignatureIndex> signatures;  // 过滤签名对不上的间接调用目标
+    std::shared_ptr<const GlobalInitializers> globals; // 全局变量的初始内容，所有状态共享
+    std::shared_ptr<const PointerEquivalence> equivalence;  // 等价的指针共用代表元在状态里的条目
+    std::shared_ptr<const PointerFreeFunctions> pointerFree;  // 调用不改变状态的函数
+    std::shared_ptr<const AllocatorIndex> allocators;  // 返回新堆对象的函数，包括包装函数
+    std::shared_ptr<const TypeRelevance> relevance;    // 类型上不可能通向函数指针的值不进状态
+    std::shared_ptr<MemoryStore> heap;                 // 混合模式下全局变量和堆对象的内容，流不敏感
+    CallGraphSCC callGraph;                             // 已经解析出来的调用边
+    std::vector<Function *> callStack;                  // 正在分析的函数
+    std::map<Function *, PTASummary> summaries;   // 递归函数的summary
+    std::set<Function *> unstableHeads;                // 需要再迭代一轮的SCC头
+
+    SummaryTable *summaryTable = nullptr;              // bottom-up模式下共享的summary
+    Function *summaryFunction = nullptr;               // 正在计算summary的函数
+    std::function<bool(Function *)> summaryGate;       // 是否要等callee的summary
+    std::set<CallInst *> pendingCalls;                 // 依赖形参才能解析的调用点
+    std::map<Value *, Placeholder> placeholders;       // 占位对象 -> 它代表的内存位置
+    std::map<Function *, DataflowResult<LivenessInfo>::Type> liveness;  // 每个函数算一次
+    std::map<Function *, std::set<Value *>> indirectCallOperands;       // 见pendingOperands
+
+    unsigned parallelCallees = 0;                      // 并行分析callee的最少个数，0表示关闭
+    ThreadBudget *threadBudget = nullptr;
+
+    ///
+    /// A function on the explicit analysis stack: the SCC iteration around its
+    /// dataflow, the dataflow's worklist, the block being evaluated, and the
+    /// call of that block that waits for its callees.
+    ///
+    struct AnalysisFrame {
+        Function *fn;
+        PTAInfo entryVal;
+        unsigned iter = 0;
+        bool recursive = false;
+        PTASummary before;
+        PTAInfo exit;
+
+        std::set<BasicBlock *> worklist;
+        std::set<BasicBlock *> visited;
+        BasicBlock *block = nullptr;           // 正在求值的块，nullptr表示在两个块之间
+        BasicBlock::iterator next;             // 块里下一条要求值的指令
+        PTAInfo state;
+
+        CallInst *call = nullptr;              // 等callee返回的调用
+        std::vector<Function *> callees;
+        size_t calleeIndex = 0;
+        PTAInfo callEntry;                     // 调用点的入口状态
+        std::vector<PTAInfo> retPoints;
+    };
+    std::vector<AnalysisFrame> summaryStack;           // 正在计算的summary，可以在调用点挂起
+
+    /// Last resolution of a call site, see buildMayCallSet.
+    struct CallTargets {
+        std::set<MemLoc> pts;                  // 被调用指针当时的pts
+        Function *summaryFunction;             // 占位对象只在同一个summary里有意义
+        bool symbolic;
+        std::set<Function *> targets;
+    };
+    std::map<CallInst *, CallTargets> callTargets;
+
+    ///
+    /// Translates the objects of a callee summary into the caller's state at
+    /// the call: a formal becomes what the actual points to, a placeholder
+    /// whatever the memory it stands for holds.
+    ///
+    struct SummaryBinding {
+        Function *callee;
+        const PTASummary &summary;
+        const PTAInfo &entry;
+        std::map<Value *, std::set<MemLoc>> objects;   // 已经翻译过的占位对象
+        std::vector<Value *> order;                    // objects里的占位对象，按翻译的先后
+        std::set<Value *> inProgress;                  // 正在翻译的占位对象
+        std::set<Value *> cyclic;                      // 翻译时从自己身上加载过的
+    };
+
+    void prepareModule(Module *M) {
+        if (!dataLayout)
+            dataLayout = std::make_shared<const DataLayout>(M->getDataLayout());
+        if (!signatures)
+            signatures = std::make_shared<SignatureIndex>(*M);
+        if (!globals)
+            globals = std::make_shared<GlobalInitializers>(*M, 0);
+        if (!equivalence)
+            equivalence = std::make_shared<PointerEquivalence>(*M);
+        if (!pointerFree)
+            pointerFree = std::make_shared<PointerFreeFunctions>(*M, *equivalence);
+        if (!allocators)
+            allocators = std::make_shared<AllocatorIndex>(*M);
+        if (!relevance)
+            relevance = std::make_shared<TypeRelevance>(*M, *equivalence);
+    }
+
+    /// Remove the SSA values of block's function that aren't live out of
+    /// block. Memory, formals, return values and values of other functions
+    /// stay. In bottom-up mode the operands of indirect calls are kept too:
+    /// a pending call is resolved again from the summary's exit state.
+    void pruneDeadValues(BasicBlock *block, PTAInfo *pPTAInfo) {
+        Function *fn = block->getParent();
+        auto it = liveness.find(fn);
+        if (it == liveness.end()) {
+            LivenessVisitor visitor;
+            LivenessInfo initVal{};
+            it = liveness.emplace(fn, DataflowResult<LivenessInfo>::Type{}).first;
+            compBackwardDataflow(fn, &visitor, &it->second, initVal);
+        }
+        // 代表元的条目只要类里还有活着的成员就得留着
+        std::set<Value *> live;
+        for (auto *inst: it->second[block].second.LiveVars) {
+            live.insert(equivalence->rep(inst));
+        }
+        if (summaryTable) {
+            const auto &operands = pendingOperands(fn);
+            live.insert(operands.begin(), operands.end());
+        }
+
+        for (auto var = pPTAInfo->info.begin(); var != pPTAInfo->info.end();) {
+            auto *inst = dyn_cast<Instruction>(var->first);
+            if (inst && inst->getFunction() == fn && !live.count(inst))
+                var = pPTAInfo->info.erase(var);
+            else
+                ++var;
+        }
+    }
+
+    /// CFG edges of fn that SCCP found feasible, computed with the equivalence
+    /// classes.
+    const FeasibleEdges::Edges &feasibleEdges(Function *fn) const {
+        return equivalence->feasibleEdges(fn);
+    }
+
+    /// Representatives of the operands of fn's indirect calls, which may
+    /// become pending calls of fn's summary.
+    const std::set<Value *> &pendingOperands(Function *fn) {
+        auto it = indirectCallOperands.find(fn);
+        if (it != indirectCallOperands.end())
+            return it->second;
+        auto &operands = indirectCallOperands[fn];
+        for (auto &I: instructions(*fn)) {
+            auto *call = dyn_cast<CallInst>(&I);
+            if (!call || isa<Function>(call->getCalledOperand()->stripPointerCasts()))
+                continue;
+            for (Value *op: call->operand_values()) {
+                operands.insert(equivalence->rep(op));
+            }
+        }
+        return operands;
+    }
+
+    void pushFrame(std::vector<AnalysisFrame> *stack, Function *fn, const PTAInfo &entryVal) {
+        callGraph.addNode(fn);
+        callStack.push_back(fn);
+        stack->emplace_back();
+        stack->back().fn = fn;
+        stack->back().entryVal = entryVal;
+        startIteration(&stack->back());
+    }
+
+    /// Reset the frame's dataflow for one more iteration of fn, like
+    /// compForwardDataflow does.
+    void startIteration(AnalysisFrame *frame) {
+        Function *fn = frame->fn;
+        PTAInfo entry = frame->entryVal;
+        // summary的SCC由调用者迭代
+        frame->recursive = !summaryTable && callGraph.isRecursive(fn);
+        if (frame->recursive)
+            merge(&entry, summaries[fn].entry);
+        if (!summaryTable)
+            frame->before = summaries[fn];
+
+        for (auto &BB: *fn) {
+            (*dfResult)[&BB] = std::make_pair(&BB == &fn->getEntryBlock() ? entry : PTAInfo{}, PTAInfo{});
+        }
+        frame->worklist = {&fn->getEntryBlock()};
+        frame->visited.clear();
+        frame->block = nullptr;
+    }
+
+    /// Run the top frame until it either finishes or pushes a callee.
+    /// @return true if the frame is done, its exit state is set
+    bool runFrame(std::vector<AnalysisFrame> *stack) {
+        AnalysisFrame &frame = stack->back();
+        const auto &feasible = feasibleEdges(frame.fn);
+        for (;;) {
+            if (!frame.block) {
+                if (frame.worklist.empty()) {
+                    if (finishIteration(&frame))
+                        return true;
+                    continue;
+                }
+                BasicBlock *bb = *frame.worklist.begin();
+                frame.worklist.erase(frame.worklist.begin());
+                frame.state = (*dfResult)[bb].first;
+                // 没求值过的块的出口还是空的，不是“什么都没写”
+                bool empty = bb != &frame.fn->getEntryBlock() && !frame.visited.count(bb);
+                for (auto *pred: predecessors(bb)) {
+                    if (!feasible.count({pred, bb}) || !frame.visited.count(pred))
+                        continue;
+                    if (empty)
+                        frame.state = (*dfResult)[pred].second;
+                    else
+                        mergeAtJoin(&frame.state, (*dfResult)[pred].second);
+                    empty = false;
+                }
+                (*dfResult)[bb].first = frame.state;
+                frame.block = bb;
+                frame.next = bb->begin();
+            }
+
+            // 调用点在等callee：先把剩下的callee处理完
+            if (frame.call && !advanceCall(stack))
+                return false;
+
+            while (frame.next != frame.block->end()) {
+                Instruction *inst = &*frame.next++;
+                auto *call = dyn_cast<CallInst>(inst);
+                if (!call || !isReportedCall(call)) {
+                    compDFVal(inst, &frame.state);
+                    continue;
+                }
+                const auto *mayCall = beginCall(call, &frame.state);
+                if (!mayCall)
+                    continue;
+                frame.call = call;
+                frame.callees.assign(mayCall->begin(), mayCall->end());
+                frame.calleeIndex = 0;
+                frame.callEntry = frame.state;
+                frame.retPoints.clear();
+                if (useParallelCallees(frame.callees.size())) {
+                    frame.retPoints = evalCallTargetsParallel(call, frame.callees, frame.callEntry);
+                    frame.calleeIndex = frame.callees.size();
+                }
+                if (!advanceCall(stack))
+                    return false;
+            }
+
+            // 块求值完了，和compForwardDataflow一样往后继传
+            BasicBlock *bb = frame.block;
+            frame.block = nullptr;
+            pruneDeadValues(bb, &frame.state);
+            bool firstVisit = frame.visited.insert(bb).second;
+            if (frame.state == (*dfResult)[bb].second && !firstVisit)
+                continue;
+            (*dfResult)[bb].second = frame.state;
+            for (auto *succ: successors(bb)) {
+                if (feasible.count({bb, succ}))
+                    frame.worklist.insert(succ);
+            }
+        }
+    }
+
+    /// The dataflow of the frame reached its fixpoint: decide whether fn's
+    /// SCC needs another iteration.
+    /// @return true if the frame is done
+    bool finishIteration(AnalysisFrame *frame) {
+        Function *fn = frame->fn;
+        frame->exit = (*dfResult)[&fn->back()].second;
+        if (summaryTable || (!frame->recursive && !callGraph.isRecursive(fn)))
+            return true;
+        auto &summary = summaries[fn];
+        merge(&summary.exit, frame->exit);
+        // 任何成员的summary变了，整个SCC都要再来一轮
+        if (!(summary == frame->before))
+            unstableHeads.insert(sccHead(fn));
+
+        // 只有SCC的头负责迭代，内层的成员直接返回本次结果
+        if (unstableHeads.erase(fn) == 0)
+            return true;
+        if (frame->iter >= MaxSCCIterations) {
+            Warning << "SCC of " << fn->getName() << " did not converge, giving up. \n";
+            return true;
+        }
+        ++frame->iter;
+        startIteration(frame);
+        return false;
+    }
+
+    /// Evaluate the remaining callees of the top frame's pending call, up to
+    /// the first one that needs its own frame or whose summary is awaited.
+    /// @return false if a callee's frame was pushed or the frame suspended
+    bool advanceCall(std::vector<AnalysisFrame> *stack) {
+        AnalysisFrame &frame = stack->back();
+        while (frame.calleeIndex < frame.callees.size()) {
+            Function *func = frame.callees[frame.calleeIndex];
+            if (awaitsSummary(func))
+                return false;
+            PTAInfo result;
+            if (!evalCallTargetDirectly(frame.call, func, frame.callEntry, &result)) {
+                PTAInfo calleeFrame = enterCallTarget(frame.call, func, frame.callEntry);
+                if (!isOnStack(func)) {
+                    pushFrame(stack, func, calleeFrame);   // frame不能再用了
+                    return false;
+                }
+                result = returnFromCallTarget(frame.call, func, frame.callEntry,
+                                              evalRecursiveCall(func, calleeFrame), true);
+            }
+            frame.retPoints.push_back(std::move(result));
+            ++frame.calleeIndex;
+        }
+        finishCall(frame.call, frame.retPoints, frame.callEntry, &frame.state);
+        frame.call = nullptr;
+        return true;
+    }
+
+    /// The callee the frame's pending call waits for returned with exit.
+    void resumeCall(AnalysisFrame *frame, const PTAInfo &exit) {
+        Function *func = frame->callees[frame->calleeIndex];
+        frame->retPoints.push_back(returnFromCallTarget(frame->call, func, frame->callEntry, exit, false));
+        ++frame->calleeIndex;
+    }
+
+    bool awaitsSummary(Function *func) {
+        if (!summaryTable || !summaryGate || func->isDeclaration() || pointerFree->isPointerFree(func))
+            return false;
+        return summaryGate(func);
+    }
+
+    bool isOnStack(Function *fn) const {
+        return std::find(callStack.begin(), callStack.end(), fn) != callStack.end();
+    }
+
+    /// The outermost function on the analysis stack that is in fn's SCC.
+    Function *sccHead(Function *fn) {
+        for (auto *f: callStack) {
+            if (callGraph.inSameSCC(f, fn))
+                return f;
+        }
+        return fn;
+    }
+
+    /// Result of a recursive call into fn, which is already being analyzed:
+    /// record the calling context in fn's summary and use its current exit.
+    /// A new context shows up when fn's frame finishes and compares its
+    /// summary with the one it started from.
+    PTAInfo evalRecursiveCall(Function *fn, const PTAInfo &entryVal) {
+        Info << "Recursive call to " << fn->getName() << ", using its summary. \n";
+        auto &summary = summaries[fn];
+        merge(&summary.entry, entryVal);
+
+        PTAInfo result = entryVal;
+        merge(&result, summary.exit);
+        return result;
+    }
+
+    /// Locations v points to, that is its representative: functions, globals
+    /// and constant expressions over them are known without the state (the
+    /// expressions resolved once by the equivalence pass), everything else
+    /// comes from the state.
+    std::set<MemLoc> ptsOf(Value *v, const PTAInfo &ptaInfo) const {
+        v = equivalence->rep(v);
+        if (auto *C = dyn_cast<Constant>(v))
+            return equivalence->locationsOf(C, *dataLayout);
+        auto it = ptaInfo.info.find(v);
+        return it == ptaInfo.info.end() ? std::set<MemLoc>{} : it->second;
+    }
+
+    /// Set v's points-to set, that is the one of v's equivalence class.
+    void bindPointer(Value *v, std::set<MemLoc> pts, PTAInfo *pPTAInfo) const {
+        pPTAInfo->setPointerAndPTS(equivalence->rep(v), std::move(pts));
+    }
+
+    /// Initial contents of loc if it is a field of a global, nullptr otherwise.
+    const std::set<MemLoc> *initialContents(const MemLoc &loc) const {
+        return globals ? globals->lookup(loc) : nullptr;
+    }
+
+    /// In hybrid mode: loc isn't an alloca's, its contents are in heap.
+    bool inHeap(const MemLoc &loc) const {
+        return heap && !isa<AllocaInst>(loc.first);
+    }
+
+    /// Whether a write to loc may replace what it held: loc is exactly one
+    /// field of an object that stands for a single object at run time. Those
+    /// are globals, allocas of functions outside call cycles and allocation
+    /// sites that run at most once. Within a summary, so are the formals'
+    /// objects and the placeholders of loads outside loops, once per call;
+    /// applying the summary decides again for the caller's locations.
+    bool allowsStrongUpdate(const MemLoc &loc) {
+        Value *obj = loc.first;
+        if (inHeap(loc) || !hasExactFields(obj, *dataLayout))
+            return false;
+        if (isa<GlobalVariable>(obj) || isa<Argument>(obj))
+            return true;
+        if (auto *alloca = dyn_cast<AllocaInst>(obj))
+            return !callGraph.isRecursive(alloca->getFunction());
+        if (isa<LoadInst>(obj))
+            return !allocators->isOnCycle(cast<LoadInst>(obj)->getParent());
+        auto *call = dyn_cast<CallInst>(obj);
+        return call && !placeholders.count(call) && allocators->runsOnce(call);
+    }
+
+    /// The store that holds loc: heap or the state's memory.
+    MemoryStore &storeOf(const MemLoc &loc, PTAInfo *pPTAInfo) const {
+        return inHeap(loc) ? *heap : pPTAInfo->mutableMemory();
+    }
+
+    /// loc's entry in the state, for a weak update: a field the state never
+    /// wrote starts out with its initial contents.
+    std::set<MemLoc> &fieldOf(const MemLoc &loc, PTAInfo *pPTAInfo) const {
+        auto &mem = storeOf(loc, pPTAInfo);
+        auto it = mem.find(loc);
+        if (it != mem.end())
+            return it->second;
+        auto &field = mem[loc];
+        if (auto *initial = initialContents(loc))
+            field = *initial;
+        return field;
+    }
+
+    /// The fields in [start, start + length) of start's object, keyed by
+    /// their offset from start.
+    std::map<int64_t, std::set<MemLoc>> readRange(const MemLoc &start, int64_t length,
+                                                  const PTAInfo &ptaInfo) const {
+        std::map<int64_t, std::set<MemLoc>> fields;
+        const auto &mem = inHeap(start) ? *heap : ptaInfo.memory();
+        for (auto it = mem.lower_bound(start);
+             it != mem.end() && it->first.first == start.first &&
+             it->first.second - start.second < length; ++it) {
+            fields[it->first.second - start.second] = it->second;
+        }
+        if (!globals)
+            return fields;
+        const auto &facts = globals->getFacts();
+        for (auto it = facts.lower_bound(start);
+             it != facts.end() && it->first.first == start.first &&
+             it->first.second - start.second < length; ++it) {
+            fields.insert({it->first.second - start.second, it->second});   // 状态里写过的优先
+        }
+        return fields;
+    }
+
+    /// In bottom-up mode: obj is a formal of the summarized function or a
+    /// placeholder for memory only its callers know.
+    bool isSymbolic(Value *obj) const {
+        if (!summaryFunction) return false;
+        auto *arg = dyn_cast<Argument>(obj);
+        return (arg && arg->getParent() == summaryFunction) || placeholders.count(obj);
+    }
+
+    /// In bottom-up mode: obj is memory whose contents only the callers of the
+    /// summarized function know, a symbolic object or a global.
+    bool isCallerMemory(Value *obj) const {
+        return isSymbolic(obj) || (summaryFunction && isa<GlobalVariable>(obj));
+    }
+
+    /// A weak update of loc is about to happen: in bottom-up mode a location
+    /// of the callers the summarized function hasn't written keeps the
+    /// contents the caller put there.
+    void keepOriginalContents(const MemLoc &loc, PTAInfo *pPTAInfo) const {
+        if (!pPTAInfo->hasLocation(loc) && !inHeap(loc) && isCallerMemory(loc.first))
+            pPTAInfo->unwritten.insert(loc);
+    }
+
+    /// A field of a global that only one side of a join wrote still holds
+    /// its initial contents on the other side: put them in dest before src is
+    /// merged in. In bottom-up mode unwritten stands for them instead.
+    void keepInitialContents(PTAInfo *dest, const PTAInfo &src) const {
+        if (!globals || summaryFunction || dest->sharedMem == src.sharedMem) return;
+        for (const auto &fact: globals->getFacts()) {
+            if (inHeap(fact.first) || dest->hasLocation(fact.first) == src.hasLocation(fact.first))
+                continue;
+            dest->mutableMemory()[fact.first].insert(fact.second.begin(), fact.second.end());
+        }
+    }
+
+    /// Strong update of a whole range to "no pointers". Initial contents of a
+    /// global, and in bottom-up mode the callers' contents of their memory,
+    /// are shadowed by empty entries.
+    void clearRange(const MemLoc &start, int64_t length, PTAInfo *pPTAInfo) const {
+        if (inHeap(start))   // 流不敏感的位置只能弱更新
+            return;
+        pPTAInfo->clear(start, length);
+        if (isCallerMemory(start.first)) {
+            int64_t slot = dataLayout->getPointerSize();
+            for (int64_t offset = 0; offset < std::min(length, objectSize(start.first, *dataLayout)); offset += slot) {
+                pPTAInfo->store(fieldAt(start.first, start.second + offset, *dataLayout), std::set<MemLoc>{});
+            }
+        }
+        if (!globals)
+            return;
+        const auto &facts = globals->getFacts();
+        for (auto it = facts.lower_bound(start);
+             it != facts.end() && it->first.first == start.first &&
+             it->first.second - start.second < length; ++it) {
+            pPTAInfo->store(it->first, std::set<MemLoc>{});
+        }
+    }
+
+    /// merge at a join of predecessors, or of the return points of a call's
+    /// callees: a location only one side wrote keeps what it held before as
+    /// well, its initial contents or, in bottom-up mode, the caller's.
+    void mergeAtJoin(PTAInfo *dest, const PTAInfo &src) {
+        keepInitialContents(dest, src);
+        if (summaryFunction && dest->sharedMem != src.sharedMem) {
+            for (const auto *side: {static_cast<const PTAInfo *>(dest), &src}) {
+                const PTAInfo &other = side == &src ? *dest : src;
+                for (const auto &field: side->memory()) {
+                    if (!other.hasLocation(field.first) && !inHeap(field.first) && isCallerMemory(field.first.first))
+                        dest->unwritten.insert(field.first);
+                }
+            }
+        }
+        merge(dest, src);
+    }
 
     void evalStoreInst(StoreInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalStoreInst \n";
         Value *from = pInst->getValueOperand();
-        Value *to = pInst->getPointerOperand();
+        if (!from->getType()->isPointerTy() || !relevance->isTracked(from))
+            return;
 
-        if (pPTAInfo->hasPointer(to)) {
-            if (pPTAInfo->hasPointer(from) || isa<Function>(from))
-                pPTAInfo->setPointerAndPTS(to, std::set < Value * > {from});
-            else
-                Error << "Don't have from. \n";
-        } else {
-            Error << "StoreInst don't have from pointer and to pointer in PTAInfo. \n";
-        }
+        auto targets = ptsOf(pInst->getPointerOperand(), *pPTAInfo);
+        auto pts = ptsOf(from, *pPTAInfo);
+        if (targets.empty())
+            Debug << "StoreInst writes through a pointer that points nowhere. \n";
 
+        // 只写一个位置、这个位置只代表一个字段的时候可以强更新
+        for (const auto &loc: targets) {
+            if (targets.size() == 1 && allowsStrongUpdate(loc)) {
+                pPTAInfo->store(loc, pts);
+            } else {
+                keepOriginalContents(loc, pPTAInfo);
+                auto &field = fieldOf(loc, pPTAInfo);
+                field.insert(pts.begin(), pts.end());
+            }
+        }
     }
 
     void evalAllocaInst(AllocaInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalAllocaInst \n";
-        auto *result = dyn_cast<Value>(pInst);
-        pPTAInfo->setPointerAndPTS(result, std::set < Value * > {});
+        if (!relevance->isTracked(pInst))
+            return;
+        pPTAInfo->setPointerAndPTS(pInst, std::set<MemLoc>{MemLoc(pInst, 0)});
     }
 
     void evalLoadInst(LoadInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalLoadInst \n";
-        Value *pointer = pInst->getPointerOperand();
-        auto *result = dyn_cast<Value>(pInst);
+        if (!pInst->getType()->isPointerTy() || !relevance->isTracked(pInst))
+            return;
 
-        // bind the %pointer's pts to %result's pts。
-        if (pPTAInfo->hasPointer(pointer)) {
-            auto pointerPTS = pPTAInfo->getPTS(pointer);
-            pPTAInfo->setPointerAndPTS(result, pointerPTS);
-        } else {
-            Debug << "evalLoadInst fail! The Pointer that the loadInst loads from isn't exist in PTS! \n";
+        std::set<MemLoc> pts;
+        for (const auto &loc: ptsOf(pInst->getPointerOperand(), *pPTAInfo)) {
+            if (inHeap(loc) && heap->count(loc)) {
+                const auto &stored = heap->at(loc);
+                pts.insert(stored.begin(), stored.end());
+                continue;
+            }
+            if (pPTAInfo->hasLocation(loc)) {
+                auto stored = pPTAInfo->load(loc);
+                pts.insert(stored.begin(), stored.end());
+                if (!pPTAInfo->unwritten.count(loc))
+                    continue;
+            }
+            if (auto *initial = initialContents(loc))
+                pts.insert(initial->begin(), initial->end());
+            if (isCallerMemory(loc.first)) {
+                // 调用者的内存，内容要到调用点才知道
+                addPlaceholder(pInst, loc, *pPTAInfo);
+                pts.insert(MemLoc(pInst, 0));
+            }
         }
+        pPTAInfo->setPointerAndPTS(pInst, pts);
     }
 
     void evalGetElementPtrInst(GetElementPtrInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalGetElementPtrInst \n";
-        Value *structurePtr = pInst->getPointerOperand();
-        auto *result = dyn_cast<Value>(pInst);
-
-        if (!pPTAInfo->hasPointer(structurePtr))
-            Debug << "The pointer in getelementptrInst haven't been in the PTAInfo. \n";
-
-        auto ptrPTS = pPTAInfo->getPTS(structurePtr);
-        if (ptrPTS.size() > 1)
-            Debug << "The structure pointer's PTS has more then one pointer. \n";
-
-        pPTAInfo->setPointerAndPTS(result, std::set < Value * > {});
+        if (equivalence->isCopy(pInst) || !relevance->isTracked(pInst))
+            return;
+        auto base = ptsOf(pInst->getPointerOperand(), *pPTAInfo);
+        int64_t offset = equivalence->offsetOf(pInst, *dataLayout);
+        bindPointer(pInst, shift(base, offset, *dataLayout), pPTAInfo);
+    }
 
-        if (ptrPTS.empty() || isa<StoreInst>(pInst->getNextNode())) {  // store mode
-//            ptrPTS.insert(result);
-            pPTAInfo->setPointerAndPTS(structurePtr, std::set < Value * > {result});
-        } else {   // load mode
-            auto innerPtr = *(ptrPTS.begin());
-            if (!pPTAInfo->hasPointer(innerPtr))
-                Debug << "Wrong Pointer. \n";
-            pPTAInfo->setPointerAndPTS(result, std::set < Value * > {innerPtr});
+    /// memcpy/memmove: every field of the source range goes to the same
+    /// offset of the destination range.
+    void evalMemTransferInst(MemTransferInst *pInst, PTAInfo *pPTAInfo) {
+        Info << "evalMemTransferInst \n";
+        auto sources = ptsOf(pInst->getRawSource(), *pPTAInfo);
+        auto dests = ptsOf(pInst->getRawDest(), *pPTAInfo);
+        auto *len = dyn_cast<ConstantInt>(pInst->getLength());
+        int64_t length = len ? len->getSExtValue() : INT64_MAX;
+
+        // 先把源区间读出来，memmove的源和目的可能重叠
+        std::map<int64_t, std::set<MemLoc>> fields;   // 相对偏移 -> pts
+        for (const auto &src: sources) {
+            auto read = readRange(src, length, *pPTAInfo);
+            for (const auto &field: read) {
+                fields[field.first].insert(field.second.begin(), field.second.end());
+            }
+            if (!isCallerMemory(src.first))
+                continue;
+            // 调用者的内存：没写过的指针槽都由一个以这条指令命名的占位对象代表
+            int64_t slot = dataLayout->getPointerSize();
+            for (int64_t offset = 0; offset < std::min(length, objectSize(src.first, *dataLayout)); offset += slot) {
+                auto loc = fieldAt(src.first, src.second + offset, *dataLayout);
+                if (read.count(offset) && !pPTAInfo->unwritten.count(loc))
+                    continue;
+                addPlaceholder(pInst, loc, *pPTAInfo);
+                fields[offset].insert(MemLoc(pInst, 0));
+            }
         }
 
+        bool strong = dests.size() == 1 && len && !sources.empty() && allowsStrongUpdate(*dests.begin());
+        if (strong)
+            clearRange(*dests.begin(), length, pPTAInfo);
+        for (const auto &dest: dests) {
+            for (const auto &field: fields) {
+                auto loc = fieldAt(dest.first, dest.second + field.first, *dataLayout);
+                if (!strong)
+                    keepOriginalContents(loc, pPTAInfo);
+                auto &stored = fieldOf(loc, pPTAInfo);
+                stored.insert(field.second.begin(), field.second.end());
+            }
+        }
     }
 
-    void evalMemCpyInst(MemCpyInst *pInst, PTAInfo *pPTAInfo) {
-        Info << "evalMemCpyInst \n";
-
-        // getSource()和getDest()函数可以自动处理BitCast，提取出最终的操作数
-        Value *source = pInst->getSource();
-        Value *dest = pInst->getDest();
-        pPTAInfo->setPointerAndPTS(dest, pPTAInfo->getPTS(source));
-
+    /// memset writes no pointers, it only kills what the range held.
+    void evalMemSetInst(MemSetInst *pInst, PTAInfo *pPTAInfo) {
+        Info << "evalMemSetInst \n";
+        auto dests = ptsOf(pInst->getRawDest(), *pPTAInfo);
+        auto *len = dyn_cast<ConstantInt>(pInst->getLength());
+        if (dests.size() == 1 && len && allowsStrongUpdate(*dests.begin()))
+            clearRange(*dests.begin(), len->getSExtValue(), pPTAInfo);
     }
 
     void evalBitCastInst(BitCastInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalBitCastInst \n";
-        Value *ptr = pInst->getOperand(0);
-        auto *result = dyn_cast<Value>(pInst);
-
-        if (!pPTAInfo->hasPointer(ptr))
-            Error << "Don't has pointer in BitCastInst.\n";
-//        pPTAInfo->setPointerAndPTS(ptr, std::set<Value*>{result});
-        pPTAInfo->setPointerAndPTS(result, std::set<Value*>{ptr});
-
+        if (!pInst->getType()->isPointerTy() || equivalence->isCopy(pInst) || !relevance->isTracked(pInst))
+            return;
+        bindPointer(pInst, ptsOf(pInst->getOperand(0), *pPTAInfo), pPTAInfo);
     }
 
     void evalReturnInst(ReturnInst *pInst, PTAInfo *pPTAInfo) {
@@ -451,190 +1314,571 @@ private:
             return ;
         }
 
-        if (!pPTAInfo->hasPointer(retValue))
-            Error << "ReturnInst don't have retValue in PTAInfo.\n";
-
-//        Info << "Has pointer return value. \n";
-        auto pts = pPTAInfo->getPTS(retValue);
-        pPTAInfo->setPointerAndPTS(func, pts);
-//        pPTAInfo->setPointerAndPTS(func, std::set<Value*>{});
+        pPTAInfo->setPointerAndPTS(func, ptsOf(retValue, *pPTAInfo));
     }
 
     void evalPhiNode(PHINode *phiNode, PTAInfo *pPTAInfo) {
         Info << "evalPhiNode \n";
-        auto* result = dyn_cast<Value>(phiNode);
-        //
-        std::set<Value*> pts;
-        for (Value *val: phiNode->incoming_values()) {
-            if (isa<ConstantPointerNull>(val))
+        if (!phiNode->getType()->isPointerTy() || equivalence->isCopy(phiNode) || !relevance->isTracked(phiNode))
+            return;
+
+        // 不可行的边带来的值不算
+        const auto &feasible = feasibleEdges(phiNode->getFunction());
+        std::set<MemLoc> pts;
+        for (unsigned i = 0; i < phiNode->getNumIncomingValues(); ++i) {
+            if (!feasible.count({phiNode->getIncomingBlock(i), phiNode->getParent()}))
                 continue;
-            pts.insert(val);
+            auto valPTS = ptsOf(phiNode->getIncomingValue(i), *pPTAInfo);
+            pts.insert(valPTS.begin(), valPTS.end());
         }
-        pPTAInfo->setPointerAndPTS(result, pts);
+        bindPointer(phiNode, pts, pPTAInfo);
     }
 
-    void evalCallInst(CallInst *pInst, PTAInfo *pPTAInfo) {
+    void evalSelectInst(SelectInst *pInst, PTAInfo *pPTAInfo) {
+        Info << "evalSelectInst \n";
+        if (!pInst->getType()->isPointerTy() || equivalence->isCopy(pInst) || !relevance->isTracked(pInst))
+            return;
+
+        auto pts = ptsOf(pInst->getTrueValue(), *pPTAInfo);
+        auto falsePTS = ptsOf(pInst->getFalseValue(), *pPTAInfo);
+        pts.insert(falsePTS.begin(), falsePTS.end());
+        bindPointer(pInst, pts, pPTAInfo);
+    }
+
+    /// Evaluate a call up to its callees: an allocation call completely,
+    /// otherwise resolve and record the callees.
+    /// @return the callees, nullptr if the call is done
+    const std::set<Function *> *beginCall(CallInst *pInst, PTAInfo *pPTAInfo) {
         Info << "evalCallInst \n";
         Value *funcPointer = pInst->getCalledOperand();
         unsigned lineno = pInst->getDebugLoc().getLine();
 //        Error << lineno << funcPointer->getName();
 
-        // 对malloc进行特判
-        if (funcPointer->getName() == "malloc") {
+        // C的分配函数：每个分配点是一个堆对象
+        auto *allocator = dyn_cast<Function>(funcPointer->stripPointerCasts());
+        if (allocator && allocator->isDeclaration() && allocators->isAllocationCall(pInst)) {
             functionCallResult[lineno] = std::set<std::string>{funcPointer->getName()};
-            pPTAInfo->setPointerAndPTS(dyn_cast<Value>(pInst), std::set<Value*>{});
-            return;
+            evalAllocationCall(pInst, pPTAInfo);
+            return nullptr;
         }
 
-        if (functionCallResult.find(lineno) == functionCallResult.end())
-            functionCallResult[lineno] = std::set<std::string>{};
-
         // 构建调用集合
-        auto mayCallFuncSet = buildMayCallSet(funcPointer, pPTAInfo);
+        bool symbolic = false;
+        const auto &mayCallFuncSet = buildMayCallSet(pInst, pPTAInfo, &symbolic);
+        if (summaryTable && symbolic)
+            pendingCalls.insert(pInst);
 
         // 保存调用点信息
-        std::set<std::string> mayCallSet;
-        for (auto* val : mayCallFuncSet) {
-//            Error << val->getName() ;
-            mayCallSet.insert(val->getName());
-        }
-        auto funcNameSet = functionCallResult[lineno];
-        std::set<std::string> mergedSet;
-        std::set_union(funcNameSet.begin(), funcNameSet.end(), mayCallSet.begin(), mayCallSet.end(), std::inserter(mergedSet, mergedSet.begin()));
-        functionCallResult[lineno] = mergedSet;
-
-        bool flag = false;
-        PTAInfo tmp = *pPTAInfo; // 保存程序点入口状态
-        std::vector<PTAInfo> retPoints;  // 保存程序点call结束状态集合
-        // 进入新函数中。
-        for (auto *f : mayCallFuncSet) {
-            *pPTAInfo = tmp;
-
-            if (!isa<Function>(f))
-                Error << "mayCallFuncSet has wrong val that isn't a Function. \n";
-            auto* func = dyn_cast<Function>(f);
-
-            // 如果是指针类型，进行参数绑定
-            for (unsigned i = 0, num = pInst->getNumArgOperands(); i < num; i++) {
-                auto *callerArg = pInst->getArgOperand(i); // 取得实参。
-                // 只处理指针传递就可以了，相当于load
-                if (!callerArg->getType()->isPointerTy())
-                    continue;
-                auto *calleeArg = func->getArg(i); // 取得形参。
+        recordCallResult(pInst, mayCallFuncSet);
+        return &mayCallFuncSet;
+    }
 
-                // 取得实参的pts
-                std::set<Value*> callerPts;
-                if (pPTAInfo->hasPointer(callerArg)) {
-                    callerPts = pPTAInfo->getPTS(callerArg);
-                }
-                else if (isa<Function>(callerArg)) {
-                    callerPts.insert(callerArg);
-                }
-                else
-                    Error << "Don't have actual Arg pointer in callInst.\n";
-
-                // 将实参的pts绑定到形参上
-                if (pPTAInfo->hasPointer(calleeArg)) { // 如果形参已经被绑定过了，只需要合并pts。
-                    auto calleePts = pPTAInfo->getPTS(calleeArg);
-                    calleePts.merge(callerPts);
-                    pPTAInfo->setPointerAndPTS(calleeArg, calleePts);
-                }
-                else {  // 没有绑定过，将pts绑定上去。
-                    pPTAInfo->setPointerAndPTS(calleeArg, callerPts);
-                }
+    bool useParallelCallees(size_t callees) const {
+        return threadBudget && !summaryTable && !heap && parallelCallees && callees >= parallelCallees;
+    }
+
+    /// Merge the states at the return points of the callees into the state
+    /// after the call.
+    void finishCall(CallInst *pInst, std::vector<PTAInfo> &retPoints, const PTAInfo &entry, PTAInfo *pPTAInfo) {
+        if (useParallelCallees(retPoints.size())) {
+            *pPTAInfo = reduceParallel(retPoints, entry);
+        } else {
+            // 合并所有返回程序点的状态。
+            *pPTAInfo = retPoints.empty() ? entry : retPoints[0];
+            for (size_t i = 1; i < retPoints.size(); ++i) {
+                mergeAtJoin(pPTAInfo, retPoints[i]);
+            }
+        }
+
+        // 分配函数的包装：它分配的对象归到这个调用点上
+        if (allocators->isAllocationCall(pInst))
+            bindAllocationSite(pInst, pPTAInfo);
+    }
+
+    /// malloc/calloc/realloc: the call site is the object. realloc keeps the
+    /// contents of the block it resizes.
+    void evalAllocationCall(CallInst *pInst, PTAInfo *pPTAInfo) {
+        MemLoc site(pInst, 0);
+        auto *allocator = dyn_cast<Function>(pInst->getCalledOperand()->stripPointerCasts());
+        if (allocator->getName() == "realloc" && pInst->getNumArgOperands() > 0) {
+            for (const auto &old: ptsOf(pInst->getArgOperand(0), *pPTAInfo)) {
+                copyContents(old, site, pPTAInfo);
             }
+        }
+        pPTAInfo->setPointerAndPTS(pInst, std::set<MemLoc>{site});
+    }
 
-            // 改变控制流
-            PTAInfo initVal{};
-            auto newPTAInfo = compForwardDataflow(func, this, dfResult, initVal, *pPTAInfo);
+    /// A call to an allocation wrapper: what the wrapper allocated is copied
+    /// to this call site, so each site keeps its own contents no matter how
+    /// many sites share the wrapper. The wrapper's object keeps its contents,
+    /// it stands for the objects of all the sites.
+    void bindAllocationSite(CallInst *pInst, PTAInfo *pPTAInfo) {
+        std::set<MemLoc> pts;
+        for (const auto &loc: ptsOf(pInst, *pPTAInfo)) {
+            MemLoc site(pInst, loc.second);
+            if (loc.first != pInst)
+                copyContents(MemLoc(loc.first, 0), MemLoc(pInst, 0), pPTAInfo);
+            pts.insert(site);
+        }
+        if (pts.empty())   // 还没分析过包装函数也至少是一个新对象
+            pts.insert(MemLoc(pInst, 0));
+        pPTAInfo->setPointerAndPTS(pInst, pts);
+    }
 
-            *pPTAInfo = newPTAInfo;
+    /// Copy every field of from's object at or after from's offset to the same
+    /// relative offset of to.
+    void copyContents(const MemLoc &from, const MemLoc &to, PTAInfo *pPTAInfo) const {
+        auto &src = storeOf(from, pPTAInfo);
+        auto &dst = storeOf(to, pPTAInfo);
+        for (auto it = src.lower_bound(from); it != src.end() && it->first.first == from.first; ++it) {
+            auto pts = it->second;
+            MemLoc dest = fieldAt(to.first, to.second + it->first.second - from.second, *dataLayout);
+            dst[dest].insert(pts.begin(), pts.end());
+        }
+    }
 
-            // 返回值绑定
-            auto *callResult = dyn_cast<Value>(pInst);
-            if (!func->getReturnType()->isPointerTy()) {
-                Info << "Function " << func->getName() << " don't has a pointer return type. Don't need to bind retVal. \n";
+    /// State after calling func from pInst, starting from the call's entry
+    /// state. The callee's frame starts with only its formals and shares the
+    /// caller's memory; the caller's frame is put back when it returns.
+    PTAInfo evalCallTarget(CallInst *pInst, Function *func, const PTAInfo &entry) {
+        PTAInfo result;
+        if (evalCallTargetDirectly(pInst, func, entry, &result))
+            return result;
+
+        PTAInfo frame = enterCallTarget(pInst, func, entry);
+        // 改变控制流，递归调用不能重入正在分析的函数
+        bool recursive = isOnStack(func);
+        PTAInfo exit = recursive ? evalRecursiveCall(func, frame) : analyzeFunction(func, frame);
+        return returnFromCallTarget(pInst, func, entry, exit, recursive);
+    }
+
+    /// The calls that don't analyze func's body: external functions,
+    /// pointer-free functions and, in bottom-up mode, summaries.
+    /// @return false if func has to be analyzed from the entry state
+    bool evalCallTargetDirectly(CallInst *pInst, Function *func, const PTAInfo &entry, PTAInfo *result) {
+        // 外部函数没有函数体，调用不改变状态
+        if (func->isDeclaration()) {
+            *result = entry;
+            return true;
+        }
+
+        callGraph.addEdge(pInst->getFunction(), func);
+        // 不碰指针的函数不用分析，只记下它里面的调用点
+        if (pointerFree->isPointerFree(func)) {
+            addResults(pointerFree->callsOf(func));
+            *result = entry;
+            return true;
+        }
+        if (summaryTable) {
+            // summary里的指针要在调用者的栈帧里做替换，仍然用整个状态
+            PTAInfo ptaInfo = entry;
+            bindArguments(pInst, func, entry, &ptaInfo);
+            ptaInfo = applySummary(pInst, func, ptaInfo);
+            bindReturnValue(pInst, func, ptaInfo, &ptaInfo);
+            *result = ptaInfo;
+            return true;
+        }
+        return false;
+    }
+
+    /// Entry state of func called from pInst: its formals and the caller's
+    /// memory.
+    PTAInfo enterCallTarget(CallInst *pInst, Function *func, const PTAInfo &entry) {
+        PTAInfo frame;
+        frame.shareMemory(entry);
+        bindArguments(pInst, func, entry, &frame);
+        return frame;
+    }
+
+    /// State after the call once func returned with exit.
+    PTAInfo returnFromCallTarget(CallInst *pInst, Function *func, const PTAInfo &entry, const PTAInfo &exit,
+                                 bool recursive) {
+        PTAInfo ptaInfo;
+        ptaInfo.info = entry.info;
+        ptaInfo.shareMemory(exit);
+        bindReturnValue(pInst, func, exit, &ptaInfo);
+        // 正在分析中的递归函数的局部变量还不能丢
+        if (!recursive)
+            dropDeadLocals(func, &ptaInfo);
+        return ptaInfo;
+    }
+
+    /// Drop the contents of fn's allocas unless they are reachable from a
+    /// pointer in the state or from memory that isn't fn's frame: a local
+    /// whose address escaped to the heap, a global, the caller or the return
+    /// value stays.
+    void dropDeadLocals(Function *fn, PTAInfo *pPTAInfo) const {
+        auto isLocal = [fn](Value *obj) {
+            auto *alloca = dyn_cast<AllocaInst>(obj);
+            return alloca && alloca->getFunction() == fn;
+        };
+
+        std::set<Value *> reached;
+        std::vector<Value *> worklist;
+        auto reach = [&](const std::set<MemLoc> &pts) {
+            for (const auto &loc: pts) {
+                if (isLocal(loc.first) && reached.insert(loc.first).second)
+                    worklist.push_back(loc.first);
             }
-            else {
-                Info << "Function " << func->getName() << " has a pointer return type. Need to bind retVal. \n";
+        };
+        for (const auto &var: pPTAInfo->info) {
+            reach(var.second);
+        }
+        const auto &mem = pPTAInfo->memory();
+        for (const auto &field: mem) {
+            if (!isLocal(field.first.first))
+                reach(field.second);
+        }
+        if (heap) {
+            for (const auto &field: *heap) {
+                reach(field.second);
+            }
+        }
+        while (!worklist.empty()) {
+            Value *obj = worklist.back();
+            worklist.pop_back();
+            for (auto it = mem.lower_bound(MemLoc(obj, INT64_MIN));
+                 it != mem.end() && it->first.first == obj; ++it) {
+                reach(it->second);
+            }
+        }
 
-                if (!newPTAInfo.hasPointer(func))
-                    Error << "Don't has retValue pts\n";
+        std::vector<MemLoc> dead;
+        for (const auto &field: mem) {
+            if (isLocal(field.first.first) && !reached.count(field.first.first))
+                dead.push_back(field.first);
+        }
+        if (dead.empty())   // 没有要删的就不复制共享的内存
+            return;
+        auto &store = pPTAInfo->mutableMemory();
+        for (const auto &loc: dead) {
+            store.erase(loc);
+        }
+    }
 
-                auto funcPTS = pPTAInfo->getPTS(func);
-                pPTAInfo->setPointerAndPTS(callResult, funcPTS);
+    /// Analyze every candidate callee on its own worker: each one gets a copy
+    /// of this visitor with a private dataflow result and call-site table,
+    /// which are folded back in callee order once all workers are done.
+    std::vector<PTAInfo> evalCallTargetsParallel(CallInst *pInst, const std::vector<Function *> &callees,
+                                                 const PTAInfo &entry) {
+        Info << "Analyzing " << (int) callees.size() << " callees in parallel. \n";
+        std::vector<PTAInfo> retPoints(callees.size());
+        std::vector<DataflowResult<PTAInfo>::Type> results(callees.size());
+        std::vector<PTAVisitor> workers(callees.size(), *this);
+        for (auto &worker: workers) {
+            worker.dataLayout = std::make_shared<const DataLayout>(*dataLayout);
+        }
+
+        std::vector<std::function<void()>> tasks;
+        for (unsigned i = 0; i < callees.size(); ++i) {
+            tasks.emplace_back([&, i] {
+                workers[i].dfResult = &results[i];
+                workers[i].functionCallResult.clear();
+                retPoints[i] = workers[i].evalCallTarget(pInst, callees[i], entry);
+            });
+        }
+        threadBudget->invoke(tasks);
+
+        for (unsigned i = 0; i < callees.size(); ++i) {
+            joinWorker(workers[i], results[i]);
+        }
+        return retPoints;
+    }
+
+    /// Merge the return states pairwise, each level of the tree in parallel.
+    PTAInfo reduceParallel(std::vector<PTAInfo> &retPoints, const PTAInfo &entry) {
+        if (retPoints.empty())
+            return entry;
+
+        for (size_t stride = 1; stride < retPoints.size(); stride *= 2) {
+            std::vector<std::function<void()>> tasks;
+            for (size_t i = 0; i + stride < retPoints.size(); i += 2 * stride) {
+                tasks.emplace_back([&, i, stride] {
+                    mergeAtJoin(&retPoints[i], retPoints[i + stride]);
+                });
             }
+            threadBudget->invoke(tasks);
+        }
+        return retPoints[0];
+    }
 
-            retPoints.push_back(*pPTAInfo);
+    void joinWorker(const PTAVisitor &worker, const DataflowResult<PTAInfo>::Type &result) {
+        for (const auto &it: result) {
+            (*dfResult)[it.first] = it.second;
+        }
+        addResults(worker.functionCallResult);
+        for (const auto &it: worker.callGraph.getEdges()) {
+            callGraph.addNode(it.first);
+            for (auto *callee: it.second) {
+                callGraph.addEdge(it.first, callee);
+            }
         }
+        for (const auto &it: worker.summaries) {
+            auto &summary = summaries[it.first];
+            merge(&summary.entry, it.second.entry);
+            merge(&summary.exit, it.second.exit);
+        }
+        unstableHeads.insert(worker.unstableHeads.begin(), worker.unstableHeads.end());
+    }
 
-        // 合并所有返回程序点的状态。
-        if (retPoints.size() == 1) {
-            *pPTAInfo = retPoints[0];
-            return ;
+    void recordCallResult(CallInst *pInst, const std::set<Function *> &mayCallFuncSet) {
+        unsigned lineno = pInst->getDebugLoc().getLine();
+        auto &funcNameSet = functionCallResult[lineno];
+        for (auto* val : mayCallFuncSet) {
+//            Error << val->getName() ;
+            funcNameSet.insert(val->getName());
         }
-        *pPTAInfo = retPoints[0];
-        for (int i = 1; i < retPoints.size(); ++i) {
-            merge(pPTAInfo, retPoints[i]);
+    }
+
+    // 如果是指针类型，进行参数绑定
+    void bindArguments(CallInst *pInst, Function *func, const PTAInfo &caller, PTAInfo *pPTAInfo) {
+        for (unsigned i = 0, num = pInst->getNumArgOperands(); i < num && i < func->arg_size(); i++) {
+            auto *callerArg = pInst->getArgOperand(i); // 取得实参。
+            // 只处理指针传递就可以了
+            if (!callerArg->getType()->isPointerTy() || !relevance->isTracked(func->getArg(i)))
+                continue;
+            // 将实参的pts绑定到形参上
+            pPTAInfo->setPointerAndPTS(func->getArg(i), ptsOf(callerArg, caller));
         }
     }
 
-    std::set<Value*> buildMayCallSet(Value* funcPointer, PTAInfo* pPTAInfo) {
-        std::set<Value*> mayCallSet{};
+    // 返回值绑定
+    void bindReturnValue(CallInst *pInst, Function *func, const PTAInfo &callee, PTAInfo *pPTAInfo) {
+        auto *callResult = dyn_cast<Value>(pInst);
+        if (!func->getReturnType()->isPointerTy()) {
+            Info << "Function " << func->getName() << " don't has a pointer return type. Don't need to bind retVal. \n";
+        }
+        else {
+            Info << "Function " << func->getName() << " has a pointer return type. Need to bind retVal. \n";
 
-        std::set<Value*> worklist;
-        worklist.insert(funcPointer);
-        while (!worklist.empty()) {
-            auto val = *worklist.begin();
-            worklist.erase(val);
-            if (isa<Function>(val)) {
-                mayCallSet.insert(val);
-            } else if (pPTAInfo->hasPointer(val)) {
-                auto pts = pPTAInfo->getPTS(val);
-                for (auto *ptr: pts) {
-                    worklist.insert(ptr);
-                }
-            } else {
-                Error << "Don't have been called function Pointer in PTAInfo. \n";
+            if (!callee.hasPointer(func)) {
+                Error << "Don't has retValue pts\n";
+                return;
             }
+
+            auto funcPTS = callee.getPTS(func);
+            pPTAInfo->setPointerAndPTS(callResult, funcPTS);
         }
+    }
 
-        return mayCallSet;
+    /// Apply callee's summary to the state at pInst (arguments already bound),
+    /// then resolve the callee's pending calls in the combined state.
+    PTAInfo applySummary(CallInst *pInst, Function *callee, const PTAInfo &state) {
+        std::set<std::pair<CallInst *, Function *>> applied{{pInst, callee}};
+        PTAInfo result = state;
+        applySummary(callee, &result, applied);
+        return result;
     }
 
-};
+    void applySummary(Function *callee, PTAInfo *pPTAInfo,
+                      std::set<std::pair<CallInst *, Function *>> &applied) {
+        PTASummary summary;
+        auto it = summaries.find(callee);
+        if (it != summaries.end()) {  // 同一个SCC里正在计算的summary
+            summary = it->second;
+        } else if (!summaryTable->lookup(callee, &summary)) {
+            Info << "No summary for " << callee->getName() << " yet. \n";
+            return;
+        }
 
+        PTAInfo entry = *pPTAInfo;
+        SummaryBinding binding{callee, summary, entry, {}};
+        for (const auto &var: summary.exit.info) {
+            pPTAInfo->setPointerAndPTS(var.first, bindSet(var.second, binding));
+        }
+        // 只对应调用者一个位置、callee每条路径都写过的可以强更新
+        std::map<MemLoc, std::set<MemLoc>> writes;
+        std::set<MemLoc> weak;
+        for (const auto &field: summary.exit.memory()) {
+            auto pts = bindSet(field.second, binding);
+            auto locs = bindLoc(field.first, binding);
+            for (const auto &loc: locs) {
+                writes[loc].insert(pts.begin(), pts.end());
+                // 也可能写的是别的位置，或者callee有的路径没写
+                if (locs.size() > 1 || summary.exit.unwritten.count(field.first))
+                    weak.insert(loc);
+            }
+        }
+        for (const auto &write: writes) {
+            const MemLoc &loc = write.first;
+            if (!weak.count(loc) && allowsStrongUpdate(loc)) {
+                pPTAInfo->store(loc, write.second);
+                continue;
+            }
+            keepOriginalContents(loc, pPTAInfo);
+            auto &stored = fieldOf(loc, pPTAInfo);
+            stored.insert(write.second.begin(), write.second.end());
+        }
 
-class PTA : public ModulePass {
-public:
+        for (auto *call: summary.pending) {
+            resolvePendingCall(call, pPTAInfo, applied);
+        }
+    }
 
-    static char ID;
+    /// Locations of the caller that obj of the callee's summary stands for.
+    std::set<MemLoc> bindObject(Value *obj, SummaryBinding &binding) {
+        auto *arg = dyn_cast<Argument>(obj);
+        if (arg && arg->getParent() == binding.callee)
+            return ptsOf(arg, binding.entry);
+        auto source = binding.summary.placeholders.find(obj);
+        if (source == binding.summary.placeholders.end())
+            return std::set<MemLoc>{MemLoc(obj, 0)};
+
+        auto it = binding.objects.find(obj);
+        if (it != binding.objects.end()) {
+            if (binding.inProgress.count(obj))
+                binding.cyclic.insert(obj);
+            return it->second;
+        }
 
-    PTA() : ModulePass(ID) {}
+        // 占位对象可能从自己身上加载出来（比如沿着链表走），这时迭代到不动点，
+        // 期间用了它旧结果的翻译都作废
+        binding.inProgress.insert(obj);
+        binding.objects[obj] = std::set<MemLoc>{};
+        binding.order.push_back(obj);
+        size_t mark = binding.order.size();
+        for (;;) {
+            auto result = bindPlaceholder(obj, source->second, binding);
+            if (!binding.cyclic.erase(obj) || result == binding.objects[obj]) {
+                binding.inProgress.erase(obj);
+                return binding.objects[obj] = result;
+            }
+            for (size_t i = mark; i < binding.order.size(); ++i) {
+                binding.objects.erase(binding.order[i]);
+            }
+            binding.order.resize(mark);
+            binding.objects[obj] = result;
+        }
+    }
 
-    bool runOnModule(Module &M) override {
-//        errs() << "Hello: ";
-//        errs().write_escaped(M.getName()) << '\n';
-        M.dump();
-        errs() << "------------------------------\n";
+    /// One round of bindObject for the placeholder obj.
+    std::set<MemLoc> bindPlaceholder(Value *obj, const Placeholder &placeholder, SummaryBinding &binding) {
+        std::set<MemLoc> result;
+        for (const auto &loc: bindSet(placeholder.source, binding)) {
+            bool overwritten = false;
+            auto written = writtenBefore(placeholder.state, loc, binding, &overwritten);
+            result.insert(written.begin(), written.end());
+            if (overwritten)
+                continue;
+            if (binding.entry.hasLocation(loc)) {
+                auto stored = binding.entry.load(loc);
+                result.insert(stored.begin(), stored.end());
+                if (!binding.entry.unwritten.count(loc))
+                    continue;
+            }
+            if (auto *initial = initialContents(loc))
+                result.insert(initial->begin(), initial->end());
+            if (isSymbolic(loc.first) || isa<GlobalVariable>(loc.first)) {
+                // 调用者也不知道里面是什么，占位对象留给上一层
+                addPlaceholder(obj, loc, binding.entry);
+                result.insert(MemLoc(obj, 0));
+            }
+        }
+        return result;
+    }
 
+    /// What the callee had written to the caller's loc when it created a
+    /// placeholder, given its memory state then: the writes to its locations
+    /// that stand for loc.
+    /// @param overwritten set to true if one of them stands for loc alone,
+    /// the caller's contents of loc were gone by then
+    std::set<MemLoc> writtenBefore(const PTAInfo &state, const MemLoc &loc, SummaryBinding &binding,
+                                   bool *overwritten) {
+        std::set<MemLoc> result;
+        for (const auto &field: state.memory()) {
+            Value *obj = field.first.first;
+            auto *arg = dyn_cast<Argument>(obj);
+            bool callerVisible = (arg && arg->getParent() == binding.callee) || isa<GlobalVariable>(obj) ||
+                                 binding.summary.placeholders.count(obj);
+            if (!callerVisible)   // 被调函数自己的局部对象
+                continue;
+            auto bound = bindLoc(field.first, binding);
+            if (!bound.count(loc))
+                continue;
+            auto pts = bindSet(field.second, binding);
+            result.insert(pts.begin(), pts.end());
+            if (bound.size() == 1 && !state.unwritten.count(field.first))
+                *overwritten = true;
+        }
+        return result;
+    }
 
-        DataflowResult<PTAInfo>::Type result; // {basicBlock: (pts_in, pts_out)}
-        PTAVisitor visitor(&result);
-        PTAInfo initVal{};
+    /// obj stands for the contents of loc, which the summarized function
+    /// doesn't know in state.
+    void addPlaceholder(Value *obj, const MemLoc &loc, const PTAInfo &state) {
+        auto &placeholder = placeholders[obj];
+        placeholder.source.insert(loc);
+        PTAInfo memory;
+        memory.shareMemory(state);
+        memory.unwritten = state.unwritten;
+        placeholder.state.unionWith(memory);
+    }
+
+    std::set<MemLoc> bindLoc(const MemLoc &loc, SummaryBinding &binding) {
+        return shift(bindObject(loc.first, binding), loc.second, *dataLayout);
+    }
 
+    std::set<MemLoc> bindSet(const std::set<MemLoc> &pts, SummaryBinding &binding) {
+        std::set<MemLoc> result;
+        for (const auto &loc: pts) {
+            auto bound = bindLoc(loc, binding);
+            result.insert(bound.begin(), bound.end());
+        }
+        return result;
+    }
 
+    /// A call inside some callee whose target depends on that callee's formals;
+    /// the formals are bound now, so resolve it again in the caller's state.
+    void resolvePendingCall(CallInst *call, PTAInfo *pPTAInfo,
+                            std::set<std::pair<CallInst *, Function *>> &applied) {
+        bool symbolic = false;
+        auto mayCallFuncSet = buildMayCallSet(call, pPTAInfo, &symbolic);
+        recordCallResult(call, mayCallFuncSet);
+        if (symbolic)  // 还依赖当前函数的形参，继续交给上层的调用者
+            pendingCalls.insert(call);
+
+        for (auto *func: mayCallFuncSet) {
+            callGraph.addEdge(call->getFunction(), func);
+            if (func->isDeclaration() || !applied.insert({call, func}).second)
+                continue;
+            bindArguments(call, func, *pPTAInfo, pPTAInfo);
+            applySummary(func, pPTAInfo, applied);
+            bindReturnValue(call, func, *pPTAInfo, pPTAInfo);
+        }
+    }
 
-        // 假设最后一个函数是程序的入口函数
-        auto f = M.rbegin(), e = M.rend();
-        for (; (f->isIntrinsic() || f->empty()) && f != e; f++) {
+    /// Functions the called pointer of pInst points to, minus the ones whose
+    /// signature can't match the call. The result is reused as long as the
+    /// called pointer's points-to set stays the same, which is the common case
+    /// when the fixpoint revisits the call's block.
+    ///
+    /// @param symbolic set to true if the called pointer points to a formal
+    /// or placeholder of the function being summarized (bottom-up mode only)
+    const std::set<Function *> &buildMayCallSet(CallInst *pInst, PTAInfo* pPTAInfo, bool *symbolic = nullptr) {
+        auto pts = ptsOf(pInst->getCalledOperand(), *pPTAInfo);
+        auto cached = callTargets.find(pInst);
+        if (cached == callTargets.end() || cached->second.pts != pts || cached->second.summaryFunction != summaryFunction) {
+            CallTargets resolved{pts, summaryFunction, false, {}};
+            for (const auto &loc: pts) {
+                if (isSymbolic(loc.first))
+                    resolved.symbolic = true;
+                auto *func = dyn_cast<Function>(loc.first);
+                if (!func || loc.second != 0)
+                    continue;
+                if (signatures && !signatures->mayCall(pInst, func)) {
+                    Debug << "Signature of " << func->getName() << " doesn't match the call, skipped. \n";
+                    continue;
+                }
+                resolved.targets.insert(func);
+            }
+            cached = callTargets.insert_or_assign(pInst, std::move(resolved)).first;
         }
 
-        compForwardDataflow(&*f, &visitor, &result, initVal, initVal);
-        printDataflowResult<PTAInfo>(errs(), result);
-        visitor.printResults(errs());
-        return false;
+        if (symbolic && cached->second.symbolic)
+            *symbolic = true;
+        return cached->second.targets;
     }
+
 };
 
 
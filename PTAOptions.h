@@ -0,0 +1,95 @@
+/************************************************************************
+ *
+ * @file PTAOptions.h
+ *
+ * Command line options of the PTA pass
+ *
+ ***********************************************************************/
+
+#ifndef PTAOPTIONS_H
+#define PTAOPTIONS_H
+
+#include <llvm/Support/CommandLine.h>
+
+#include "utils.h"
+
+using namespace llvm;
+
+static cl::opt<bool>
+        PTABottomUp("pta-bottom-up",
+                    cl::desc("Compute function summaries bottom-up over the call-graph SCC DAG"),
+                    cl::init(false));
+
+static cl::opt<bool>
+        PTAAllEntries("pta-all-entries",
+                      cl::desc("Analyze main, every externally visible function and every "
+                               "address-taken function as a root, instead of the last function"),
+                      cl::init(false));
+
+static cl::opt<bool>
+        PTASteensgaard("pta-steensgaard",
+                       cl::desc("Use the unification-based, field-insensitive solver: fastest, "
+                                "and an upper bound of the other modes"),
+                       cl::init(false));
+
+static cl::opt<bool>
+        PTATiered("pta-tiered",
+                  cl::desc("Resolve call sites by type, then flow-insensitively, and run the "
+                           "flow-sensitive analysis only if a reachable one is still ambiguous"),
+                  cl::init(false));
+
+static cl::opt<bool>
+        PTAAndersen("pta-andersen",
+                    cl::desc("Use the flow-insensitive, inclusion-based solver with lazy cycle "
+                             "detection instead of the flow-sensitive analysis"),
+                    cl::init(false));
+
+static cl::opt<bool>
+        PTASparse("pta-sparse",
+                  cl::desc("Flow-sensitive along def-use chains built from the inclusion-based "
+                           "solution (staged sparse analysis)"),
+                  cl::init(false));
+
+static cl::opt<bool>
+        PTAHybrid("pta-hybrid",
+                  cl::desc("Track allocas flow-sensitively and globals and heap objects in one "
+                           "flow-insensitive store"),
+                  cl::init(false));
+
+static cl::opt<unsigned>
+        PTAThreads("pta-threads",
+                   cl::desc("Number of analysis worker threads, 0 for the hardware concurrency"),
+                   cl::init(0));
+
+static cl::opt<unsigned>
+        PTAParallelCallees("pta-parallel-callees",
+                           cl::desc("Analyze the candidate callees of a call site on separate threads "
+                                    "once there are at least this many, 0 to disable"),
+                           cl::init(0));
+
+static cl::list<std::string>
+        PTAQueries("pta-query",
+                   cl::desc("Resolve only these call sites, demand-driven "
+                            "([file:]line[:col] or function:%inst)"),
+                   cl::CommaSeparated);
+
+/// The modes are exclusive, and the hybrid mode's flow-insensitive store has
+/// no lock for callees analyzed in parallel.
+/// @return false, with the error logged, if the options can't run together
+static bool checkPTAOptions() {
+    unsigned modes = PTABottomUp + PTAAllEntries + PTASteensgaard + PTATiered + PTAAndersen + PTASparse +
+                     PTAHybrid + !PTAQueries.empty();
+    if (modes > 1) {
+        Error << "Choose at most one of -pta-bottom-up, -pta-all-entries, -pta-steensgaard, -pta-tiered, "
+                 "-pta-andersen, -pta-sparse, -pta-hybrid and -pta-query. \n";
+        return false;
+    }
+    // 流不敏感的heap没有加锁，不能多线程分析callee
+    if (PTAHybrid && PTAParallelCallees) {
+        Error << "-pta-hybrid can't be combined with -pta-parallel-callees. \n";
+        return false;
+    }
+    return true;
+}
+
+#endif //PTAOPTIONS_H
@@ -0,0 +1,156 @@
+/************************************************************************
+ *
+ * @file PTAPass.h
+ *
+ * Module pass driving the pointer analysis
+ *
+ ***********************************************************************/
+
+#ifndef PTAPASS_H
+#define PTAPASS_H
+
+#include <llvm/IR/Module.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/raw_ostream.h>
+#include <chrono>
+
+#include "Andersen.h"
+#include "BottomUp.h"
+#include "DemandPTA.h"
+#include "EntryPoints.h"
+#include "GlobalInitializers.h"
+#include "HybridPTA.h"
+#include "PTA.h"
+#include "PTAOptions.h"
+#include "SparsePTA.h"
+#include "Steensgaard.h"
+#include "TieredPTA.h"
+
+using namespace llvm;
+
+class PTA : public ModulePass {
+public:
+
+    static char ID;
+
+    PTA() : ModulePass(ID) {}
+
+    bool runOnModule(Module &M) override {
+//        errs() << "Hello: ";
+//        errs().write_escaped(M.getName()) << '\n';
+        M.dump();
+        errs() << "------------------------------\n";
+
+
+        if (!PTAQueries.empty()) {
+            runQueries(M);
+            return false;
+        }
+
+        if (PTABottomUp) {
+            BottomUpPTA bottomUp(M, PTAThreads);
+            bottomUp.run();
+            printAll(bottomUp.getDataflowResult(), bottomUp.getResults());
+            return false;
+        }
+
+        if (PTAAllEntries) {
+            MultiEntryPTA multiEntry(M, PTAThreads);
+            multiEntry.run();
+            printAll(multiEntry.getDataflowResult(), multiEntry.getResults());
+            return false;
+        }
+
+        if (PTAAndersen) {
+            AndersenPTA andersen(M, entryFunction(M), PTAThreads);
+            andersen.run();
+            printAll(andersen.getDataflowResult(), andersen.getResults());
+            return false;
+        }
+
+        if (PTASteensgaard) {
+            SteensgaardPTA steensgaard(M, entryFunction(M), PTAThreads);
+            steensgaard.run();
+            printAll(steensgaard.getDataflowResult(), steensgaard.getResults());
+            return false;
+        }
+
+        if (PTAHybrid) {
+            HybridPTA hybrid(M, entryFunction(M), PTAThreads);
+            hybrid.run();
+            printAll(hybrid.getDataflowResult(), hybrid.getResults());
+            return false;
+        }
+
+        if (PTASparse) {
+            SparsePTA sparse(M, entryFunction(M), PTAThreads);
+            sparse.run();
+            printAll(sparse.getDataflowResult(), sparse.getResults());
+            return false;
+        }
+
+        if (PTATiered) {
+            TieredPTA tiered(M, entryFunction(M), PTAThreads);
+            tiered.run();
+            printAll(tiered.getDataflowResult(), tiered.getResults());
+            return false;
+        }
+
+        DataflowResult<PTAInfo>::Type result; // {basicBlock: (pts_in, pts_out)}
+        PTAVisitor visitor(&result);
+        ThreadBudget budget(PTAThreads);
+        visitor.setParallelCallees(PTAParallelCallees, &budget);
+        visitor.setGlobalInitializers(std::make_shared<GlobalInitializers>(M, PTAThreads));
+        PTAInfo initVal{};
+
+        visitor.analyzeFunction(entryFunction(M), initVal);
+        printDataflowResult<PTAInfo>(errs(), result);
+        visitor.printResults(errs());
+        return false;
+    }
+
+private:
+    // 假设最后一个函数是程序的入口函数
+    static Function *entryFunction(Module &M) {
+        auto f = M.rbegin(), e = M.rend();
+        for (; (f->isIntrinsic() || f->empty()) && f != e; f++) {
+        }
+        return &*f;
+    }
+
+    /// Answer the -pta-query call sites only. The resolver keeps what it
+    /// solved for one query, so later queries reuse it.
+    static void runQueries(Module &M) {
+        DemandResolver resolver(M);
+        std::map<unsigned, std::set<std::string>> callResult;
+        for (const auto &query: PTAQueries) {
+            auto start = std::chrono::steady_clock::now();
+            auto sites = resolver.findCallSites(query);
+            if (sites.empty())
+                Warning << "No call site matches " << query << ". \n";
+            for (auto *call: sites) {
+                auto &names = callResult[call->getDebugLoc().getLine()];
+                for (auto *F: resolver.resolve(call)) {
+                    names.insert(F->getName());
+                }
+            }
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            Info << "Query " << query << " took " << (int) us << "us, "
+                 << (int) resolver.numNodes() << " nodes so far. \n";
+        }
+
+        DataflowResult<PTAInfo>::Type result;
+        printAll(result, callResult);
+    }
+
+    static void printAll(DataflowResult<PTAInfo>::Type &result,
+                         const std::map<unsigned, std::set<std::string>> &callResult) {
+        PTAVisitor printer(&result);
+        printer.addResults(callResult);
+        printDataflowResult<PTAInfo>(errs(), result);
+        printer.printResults(errs());
+    }
+};
+
+#endif //PTAPASS_H
@@ -0,0 +1,182 @@
+/************************************************************************
+ *
+ * @file PointerEquivalence.h
+ *
+ * Offline pointer equivalence: pointer SSA values that provably point to
+ * the same locations share one representative
+ *
+ ***********************************************************************/
+
+#ifndef POINTEREQUIVALENCE_H
+#define POINTEREQUIVALENCE_H
+
+#include <llvm/ADT/PostOrderIterator.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <map>
+#include <set>
+
+#include "FeasibleEdges.h"
+#include "MemoryModel.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Hash-based value numbering of the pointer SSA values, run once per module
+/// before the dataflow. A value is numbered by its opcode and the numbers of
+/// its operands, as far as they matter to the points-to set:
+///   - a pointer bitcast, and a GEP whose byte offset is 0, is a copy of its
+///     operand;
+///   - GEPs with the same base and offset are equivalent;
+///   - a phi or select is a copy if all its incoming values that can point
+///     anywhere are one value, and equivalent to the phis and selects over the
+///     same incoming values otherwise. A phi's incoming values only count
+///     along the CFG edges SCCP found feasible, which are kept for the
+///     dataflow as well.
+/// Loads are never numbered: what they read depends on the program point.
+///
+/// Every member of a class reads and writes its representative's entry of
+/// the state. A copy's transfer function is the identity and can be skipped.
+///
+/// The numbering resolves every GEP to its byte offset, and every constant
+/// pointer expression (a field of a global, possibly nested in several
+/// structs) to the locations it names, so both are kept: the transfer
+/// functions look them up instead of walking the types again on every visit.
+///
+/// Everything is computed in the constructor, afterwards the numbering is
+/// read-only and can be shared between analysis threads.
+///
+class PointerEquivalence {
+public:
+    explicit PointerEquivalence(Module &M) {
+        DataLayout DL(M.getDataLayout());
+        unsigned pointers = 0;
+        for (auto &F: M) {
+            if (F.isDeclaration()) continue;
+            pointers += number(F, DL);
+        }
+        Info << "Pointer equivalence: " << (int) reps.size() << " of " << (int) pointers
+             << " pointer values collapsed into a representative. \n";
+    }
+
+    /// Representative of v's class, v itself if it is in a class of its own.
+    Value *rep(Value *v) const {
+        // 回边上的phi输入可能在phi之后才找到自己的代表元
+        for (auto it = reps.find(v); it != reps.end(); it = reps.find(v)) {
+            v = it->second;
+        }
+        return v;
+    }
+
+    /// v's points-to set is its representative's by construction, evaluating v
+    /// changes nothing.
+    bool isCopy(Value *v) const {
+        return copies.count(v) != 0;
+    }
+
+    /// CFG edges of fn that can be taken, see FeasibleEdges.
+    const FeasibleEdges::Edges &feasibleEdges(Function *fn) const {
+        static const FeasibleEdges::Edges none;
+        auto it = feasible.find(fn);
+        return it == feasible.end() ? none : it->second;
+    }
+
+    /// Whether BB can be reached: it is the entry block or has a feasible
+    /// incoming edge.
+    bool isFeasible(BasicBlock *BB) const {
+        if (BB == &BB->getParent()->getEntryBlock()) return true;
+        const auto &edges = feasibleEdges(BB->getParent());
+        for (auto *pred: predecessors(BB)) {
+            if (edges.count({pred, BB}))
+                return true;
+        }
+        return false;
+    }
+
+    /// Byte offset gep adds to its base, see gepOffset.
+    int64_t offsetOf(GetElementPtrInst *gep, const DataLayout &DL) const {
+        auto it = offsets.find(gep);
+        return it != offsets.end() ? it->second : gepOffset(cast<GEPOperator>(gep), DL);
+    }
+
+    /// Locations the pointer constant C names, see constantPts.
+    std::set<MemLoc> locationsOf(Constant *C, const DataLayout &DL) const {
+        auto it = constants.find(C);
+        return it != constants.end() ? it->second : constantPts(C, DL);
+    }
+
+private:
+    std::map<Value *, Value *> reps;   // 不是代表元的指针 -> 代表元
+    std::set<Value *> copies;          // 代表元就是它的（间接）操作数
+    std::map<GetElementPtrInst *, int64_t> offsets;         // GEP -> 字节偏移
+    std::map<Constant *, std::set<MemLoc>> constants;       // 常量表达式 -> 指向的位置
+    std::map<Function *, FeasibleEdges::Edges> feasible;    // SCCP算出来的可行边
+
+    void join(Value *v, Value *representative, bool copy) {
+        if (representative == v) return;
+        reps[v] = representative;
+        if (copy)
+            copies.insert(v);
+    }
+
+    /// Number F's pointer instructions in reverse post order, so operands come
+    /// before their users except through back edges.
+    /// @return number of pointer instructions in F
+    unsigned number(Function &F, const DataLayout &DL) {
+        std::map<std::pair<Value *, int64_t>, Value *> geps;   // (基址, 偏移) -> 代表元
+        std::map<std::set<Value *>, Value *> joins;            // phi/select的输入 -> 代表元
+        unsigned pointers = 0;
+        const auto &edges = feasible[&F] = FeasibleEdges(&F).getEdges();
+
+        ReversePostOrderTraversal<Function *> rpot(&F);
+        for (auto *BB: rpot) {
+            for (auto &I: *BB) {
+                for (Value *op: I.operand_values()) {
+                    auto *expr = dyn_cast<ConstantExpr>(op);
+                    if (expr && expr->getType()->isPointerTy() && !constants.count(expr))
+                        constants[expr] = constantPts(expr, DL);
+                }
+                if (!I.getType()->isPointerTy()) continue;
+                ++pointers;
+                if (auto *bitCast = dyn_cast<BitCastInst>(&I)) {
+                    join(bitCast, rep(bitCast->getOperand(0)), true);
+                } else if (auto *gep = dyn_cast<GetElementPtrInst>(&I)) {
+                    Value *base = rep(gep->getPointerOperand());
+                    int64_t offset = offsets[gep] = gepOffset(cast<GEPOperator>(gep), DL);
+                    if (offset == 0) {
+                        join(gep, base, true);
+                    } else {
+                        auto it = geps.emplace(std::make_pair(base, offset), gep).first;
+                        join(gep, it->second, false);
+                    }
+                } else if (isa<PHINode>(&I) || isa<SelectInst>(&I)) {
+                    std::set<Value *> incoming;
+                    for (Use &use: I.operands()) {
+                        Value *v = use.get();
+                        if (!v->getType()->isPointerTy() || v == &I) continue;
+                        auto *phi = dyn_cast<PHINode>(&I);
+                        if (phi && !edges.count({phi->getIncomingBlock(use), BB})) continue;
+                        // null和undef不指向任何地方
+                        if (auto *C = dyn_cast<Constant>(v)) {
+                            if (constantPts(C, DL).empty()) continue;
+                        }
+                        incoming.insert(rep(v));
+                    }
+                    if (incoming.size() == 1) {
+                        join(&I, *incoming.begin(), true);
+                    } else if (!incoming.empty()) {
+                        auto it = joins.emplace(incoming, &I).first;
+                        join(&I, it->second, false);
+                    }
+                }
+            }
+        }
+        return pointers;
+    }
+};
+
+#endif //POINTEREQUIVALENCE_H
@@ -0,0 +1,147 @@
+/************************************************************************
+ *
+ * @file PointerFree.h
+ *
+ * Functions whose calls can't change the points-to state
+ *
+ ***********************************************************************/
+
+#ifndef POINTERFREE_H
+#define POINTERFREE_H
+
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "MemoryModel.h"
+#include "PointerEquivalence.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Classifies the defined functions of a module, once, as pointer-relevant
+/// or pointer-free. A function is pointer-relevant if it
+///   - takes or returns a pointer,
+///   - loads or stores a pointer, or copies or clears memory,
+///   - allocates (the site would be an object of the caller's state),
+///   - makes an indirect call, or calls a pointer-relevant function.
+/// Everything else - locals, scalar arithmetic, calls to external functions
+/// and to other pointer-free functions - leaves the caller's state as it was,
+/// so a call to a pointer-free function needs no analysis. What it does
+/// leave is its call sites, which all have a constant callee: they are
+/// collected here, with those of the pointer-free functions it calls. Like
+/// the analysis, the collection skips the blocks SCCP found unreachable.
+///
+/// Everything is computed in the constructor, afterwards the classification
+/// is read-only and can be shared between analysis threads.
+///
+class PointerFreeFunctions {
+public:
+    PointerFreeFunctions(Module &M, const PointerEquivalence &equivalence) {
+        std::map<Function *, std::set<Function *>> callees;   // 直接调用的有函数体的函数
+        std::map<Function *, std::set<Function *>> reachable; // 其中从可达的块里调用的
+        for (auto &F: M) {
+            if (F.isDeclaration()) continue;
+            if (isRelevantFunction(F, &callees[&F]))
+                continue;
+            auto &calls = reports[&F];
+            for (auto &I: instructions(F)) {
+                auto *call = dyn_cast<CallInst>(&I);
+                if (!call || isa<DbgInfoIntrinsic>(call) || !equivalence.isFeasible(call->getParent()))
+                    continue;
+                Value *callee = call->getCalledOperand()->stripPointerCasts();
+                calls[call->getDebugLoc().getLine()].insert(callee->getName());
+                if (auto *G = dyn_cast<Function>(callee)) {
+                    if (!G->isDeclaration())
+                        reachable[&F].insert(G);
+                }
+            }
+        }
+
+        // 调用了指针相关函数的函数也是指针相关的，直到不动点
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto it = reports.begin(); it != reports.end();) {
+                bool relevant = false;
+                for (auto *callee: callees[it->first]) {
+                    relevant |= !reports.count(callee);
+                }
+                if (relevant) {
+                    it = reports.erase(it);
+                    changed = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // 被调用的无指针函数的调用点也算进来
+        for (auto &it: reports) {
+            std::set<Function *> reached{it.first};
+            std::vector<Function *> worklist{it.first};
+            while (!worklist.empty()) {
+                Function *F = worklist.back();
+                worklist.pop_back();
+                for (auto *callee: reachable[F]) {
+                    if (!reached.insert(callee).second) continue;
+                    worklist.push_back(callee);
+                    for (const auto &call: reports.at(callee)) {
+                        it.second[call.first].insert(call.second.begin(), call.second.end());
+                    }
+                }
+            }
+        }
+        Info << "Pointer-free functions: " << (int) reports.size() << ". \n";
+    }
+
+    bool isPointerFree(Function *F) const {
+        return reports.count(F) != 0;
+    }
+
+    /// Call sites of pointer-free F and of the functions it calls, reported
+    /// the way the analysis would: line -> callee names.
+    const std::map<unsigned, std::set<std::string>> &callsOf(Function *F) const {
+        return reports.at(F);
+    }
+
+private:
+    std::map<Function *, std::map<unsigned, std::set<std::string>>> reports;   // 无指针的函数 -> 调用点
+
+    /// @return true if F is pointer-relevant by itself; otherwise callees is
+    /// set to the defined functions F calls
+    static bool isRelevantFunction(Function &F, std::set<Function *> *callees) {
+        if (F.getReturnType()->isPointerTy())
+            return true;
+        for (auto &arg: F.args()) {
+            if (arg.getType()->isPointerTy())
+                return true;
+        }
+        for (auto &I: instructions(F)) {
+            if (auto *store = dyn_cast<StoreInst>(&I)) {
+                if (store->getValueOperand()->getType()->isPointerTy())
+                    return true;
+            } else if (auto *load = dyn_cast<LoadInst>(&I)) {
+                if (load->getType()->isPointerTy())
+                    return true;
+            } else if (auto *call = dyn_cast<CallInst>(&I)) {
+                if (isa<DbgInfoIntrinsic>(call)) continue;
+                if (isa<MemIntrinsic>(call) || isAllocationCall(call))
+                    return true;
+                auto *callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+                if (!callee)
+                    return true;
+                if (!callee->isDeclaration())
+                    callees->insert(callee);
+            }
+        }
+        return false;
+    }
+};
+
+#endif //POINTERFREE_H
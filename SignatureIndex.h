@@ -0,0 +1,119 @@
+/************************************************************************
+ *
+ * @file SignatureIndex.h
+ *
+ * Address-taken functions indexed by signature, to filter indirect call
+ * targets
+ *
+ ***********************************************************************/
+
+#ifndef SIGNATUREINDEX_H
+#define SIGNATUREINDEX_H
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+#include <map>
+#include <set>
+#include <string>
+
+using namespace llvm;
+
+///
+/// Buckets the address-taken functions of a module by canonical signature
+/// (all pointer types are the same, integers only differ by width) and
+/// precomputes the bucket of every indirect call's function type. A
+/// variadic function also joins the bucket of every call type that matches
+/// its fixed parameters.
+///
+/// Everything is computed in the constructor, afterwards the index is
+/// read-only and can be shared between analysis threads.
+///
+class SignatureIndex {
+public:
+    explicit SignatureIndex(Module &M) {
+        std::map<std::string, std::set<Function *>> buckets;
+        std::set<Function *> varArgs;
+        for (auto &F: M) {
+            if (F.isIntrinsic() || !F.hasAddressTaken()) continue;
+            if (F.isVarArg())
+                varArgs.insert(&F);
+            else
+                buckets[canonical(F.getFunctionType())].insert(&F);
+        }
+
+        for (auto &F: M) {
+            for (auto &I: instructions(F)) {
+                auto *call = dyn_cast<CallInst>(&I);
+                if (!call || isa<Function>(call->getCalledOperand()->stripPointerCasts()))
+                    continue;
+                FunctionType *fty = call->getFunctionType();
+                if (callBuckets.count(fty)) continue;
+
+                auto &bucket = callBuckets[fty];
+                auto it = buckets.find(canonical(fty));
+                if (it != buckets.end())
+                    bucket = it->second;
+                for (auto *G: varArgs) {
+                    if (matchesVarArg(fty, G->getFunctionType()))
+                        bucket.insert(G);
+                }
+            }
+        }
+    }
+
+    /// @return true if call may reach F: F is the direct callee, or F is
+    /// address-taken and its signature fits the call's function type.
+    bool mayCall(CallInst *call, Function *F) const {
+        if (call->getCalledOperand()->stripPointerCasts() == F)
+            return true;
+        auto it = callBuckets.find(call->getFunctionType());
+        return it != callBuckets.end() && it->second.count(F);
+    }
+
+    /// Candidate targets of an indirect call with function type fty.
+    const std::set<Function *> &candidates(FunctionType *fty) const {
+        static const std::set<Function *> none;
+        auto it = callBuckets.find(fty);
+        return it == callBuckets.end() ? none : it->second;
+    }
+
+private:
+    std::map<FunctionType *, std::set<Function *>> callBuckets;
+
+    static std::string canonical(Type *type) {
+        if (type->isPointerTy())
+            return "ptr";
+        if (type->isIntegerTy())
+            return "i" + std::to_string(type->getIntegerBitWidth());
+        std::string name;
+        raw_string_ostream out(name);
+        type->print(out);
+        return out.str();
+    }
+
+    static std::string canonical(FunctionType *fty) {
+        std::string sig = canonical(fty->getReturnType()) + "(";
+        for (unsigned i = 0; i < fty->getNumParams(); ++i) {
+            if (i) sig += ",";
+            sig += canonical(fty->getParamType(i));
+        }
+        return sig + (fty->isVarArg() ? ",...)" : ")");
+    }
+
+    static bool matchesVarArg(FunctionType *call, FunctionType *callee) {
+        if (call->getNumParams() < callee->getNumParams() ||
+            canonical(call->getReturnType()) != canonical(callee->getReturnType()))
+            return false;
+        for (unsigned i = 0; i < callee->getNumParams(); ++i) {
+            if (canonical(call->getParamType(i)) != canonical(callee->getParamType(i)))
+                return false;
+        }
+        return true;
+    }
+};
+
+#endif //SIGNATUREINDEX_H
@@ -0,0 +1,628 @@
+/************************************************************************
+ *
+ * @file SparsePTA.h
+ *
+ * Staged sparse flow-sensitive pointer analysis: a flow-insensitive
+ * pre-analysis builds def-use chains for memory, the flow-sensitive solve
+ * only propagates along them
+ *
+ ***********************************************************************/
+
+#ifndef SPARSEPTA_H
+#define SPARSEPTA_H
+
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "Andersen.h"
+#include "CallGraph.h"
+#include "Dataflow.h"
+#include "GlobalInitializers.h"
+#include "MemoryModel.h"
+#include "PTA.h"
+#include "SignatureIndex.h"
+#include "utils.h"
+
+using namespace llvm;
+
+/// Memory nodes whose definition of a location reaches a program point.
+struct ReachingDefs {
+    std::map<MemLoc, std::set<unsigned>> defs;
+
+    bool operator==(const ReachingDefs &rhs) const {
+        return defs == rhs.defs;
+    }
+};
+
+///
+/// Sparse flow-sensitive analysis in two stages (Hardekopf and Lin).
+///
+/// Stage 1 solves the module with AndersenPTA, and from its points-to sets
+/// gives every instruction that may read or write pointer-holding memory a
+/// memory node: loads, pointer stores, memcpy/memmove, realloc and calls of
+/// defined functions, plus an entry and exit node per function and a
+/// return node per call. A function's entry defines, and its exit uses,
+/// every location the function or its callees may access. A reaching
+/// definitions pass per function then links each use of a location to the
+/// nodes whose definition of it reaches the use: the def-use chains.
+///
+/// Stage 2 keeps one points-to set per SSA pointer (SSA form makes that
+/// exact) and propagates memory contents only along the def-use chains. A
+/// store to a single location of a single object is a strong update (see
+/// allowsStrongUpdate); every other memory node
+/// passes through what it doesn't overwrite, which is why a use only needs
+/// its reaching definitions. Calls are context-insensitive: the contents at
+/// every call flow into the callee's entry, its exit flows back to every
+/// return node. A location only some of a call's callees access also flows
+/// from the call to its return node as it was.
+///
+class SparsePTA {
+public:
+    SparsePTA(Module &M, Function *entry, unsigned threads)
+            : module(M), entry(entry), signatures(M), globals(M, threads), allocators(M), pre(M, entry, threads) {}
+
+    void run() {
+        auto start = std::chrono::steady_clock::now();
+        pre.solveModule();
+        buildMemoryNodes();
+        computeModRef();
+        unsigned edges = buildDefUse();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "SFS pre-analysis: " << (int) nodes.size() << " memory nodes, " << (int) edges
+             << " def-use edges in " << (int) us << "us. \n";
+
+        start = std::chrono::steady_clock::now();
+        solve();
+        reportReachableCalls(entry, [this](CallInst *call) { return targetsOf(call); }, &callResult);
+        us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "SFS solved " << (int) pts.size() << " pointers in " << (int) us << "us. \n";
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    enum class NodeKind {
+        Access,     // load/store/memcpy/realloc
+        Call,       // 调用已定义函数的调用点，把内存传给callee的入口
+        Return,     // 调用点之后，收集callee出口的内存
+        Entry,
+        Exit
+    };
+
+    struct MemNode {
+        NodeKind kind;
+        Instruction *inst;
+        std::set<MemLoc> uses;
+        std::set<MemLoc> defs;
+        std::map<MemLoc, std::set<MemLoc>> in;
+        std::map<MemLoc, std::set<MemLoc>> out;              // 只有Access节点有自己的out
+        std::map<MemLoc, std::vector<unsigned>> succs;       // def-use边
+    };
+
+    Module &module;
+    Function *entry;
+    SignatureIndex signatures;
+    GlobalInitializers globals;
+    AllocatorIndex allocators;
+    AndersenPTA pre;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+
+    // 第一阶段
+    std::vector<MemNode> nodes;
+    std::map<Instruction *, unsigned> accessNodes;   // 访存指令和调用点 -> 节点
+    std::map<CallInst *, unsigned> returnNodes;
+    std::map<CallInst *, unsigned> siteNodes;        // 分配包装的调用点：返回之后复制包装分配的对象
+    std::map<Function *, unsigned> entryNodes, exitNodes;
+    std::map<CallInst *, std::set<Function *>> preTargets;   // 预分析解析出来的有函数体的callee
+    CallGraphSCC preCalls;                                   // 预分析的调用图，判断局部变量是不是只有一份
+    std::map<Function *, std::set<MemLoc>> modRef;           // 函数及其callee可能访问的位置
+
+    // 第二阶段
+    std::map<Value *, std::set<MemLoc>> pts;
+    std::map<Function *, std::set<MemLoc>> returnPts;
+    std::map<Function *, std::set<CallInst *>> callers;
+    std::deque<Instruction *> instWorklist;
+    std::set<Instruction *> queuedInsts;
+    std::deque<std::pair<unsigned, MemLoc>> memWorklist;   // (节点, 位置)：out变了，沿def-use边传播
+
+    unsigned newNode(NodeKind kind, Instruction *inst) {
+        nodes.push_back(MemNode{kind, inst, {}, {}, {}, {}, {}});
+        return nodes.size() - 1;
+    }
+
+    static int64_t lengthOf(MemTransferInst *memCpy) {
+        auto *len = dyn_cast<ConstantInt>(memCpy->getLength());
+        return len ? len->getSExtValue() : INT64_MAX;
+    }
+
+    /// Locations of the destination a copy from src to dest of length bytes
+    /// may write, paired with the source location each one is copied from.
+    std::vector<std::pair<MemLoc, MemLoc>> copiedFields(const std::set<MemLoc> &dests,
+                                                        const std::set<MemLoc> &sources, int64_t length) {
+        std::vector<std::pair<MemLoc, MemLoc>> fields;
+        for (const auto &s: sources) {
+            for (const auto &field: pre.locationsIn(s, length)) {
+                for (const auto &d: dests) {
+                    fields.emplace_back(fieldAt(d.first, d.second + field.second - s.second, module.getDataLayout()),
+                                        field);
+                }
+            }
+        }
+        return fields;
+    }
+
+    // ---------------------------------------------------------------------
+    // 第一阶段：预分析，def-use链
+
+    void buildMemoryNodes() {
+        for (auto &F: module) {
+            if (F.isDeclaration()) continue;
+            entryNodes[&F] = newNode(NodeKind::Entry, nullptr);
+            exitNodes[&F] = newNode(NodeKind::Exit, nullptr);
+            for (auto &I: instructions(F)) {
+                if (auto *store = dyn_cast<StoreInst>(&I)) {
+                    if (!store->getValueOperand()->getType()->isPointerTy()) continue;
+                    unsigned n = accessNodes[&I] = newNode(NodeKind::Access, &I);
+                    nodes[n].defs = nodes[n].uses = pre.pointsTo(store->getPointerOperand());
+                } else if (auto *load = dyn_cast<LoadInst>(&I)) {
+                    if (!load->getType()->isPointerTy()) continue;
+                    unsigned n = accessNodes[&I] = newNode(NodeKind::Access, &I);
+                    nodes[n].uses = pre.pointsTo(load->getPointerOperand());
+                } else if (auto *memCpy = dyn_cast<MemTransferInst>(&I)) {
+                    accessNodes[&I] = addCopyNode(&I, pre.pointsTo(memCpy->getRawDest()),
+                                                  pre.pointsTo(memCpy->getRawSource()), lengthOf(memCpy));
+                } else if (auto *call = dyn_cast<CallInst>(&I)) {
+                    if (isa<DbgInfoIntrinsic>(call) || isa<MemIntrinsic>(call)) continue;
+                    if (isRealloc(call)) {
+                        accessNodes[&I] = addCopyNode(&I, std::set<MemLoc>{MemLoc(call, 0)},
+                                                      pre.pointsTo(call->getArgOperand(0)), INT64_MAX);
+                        continue;
+                    }
+                    auto &targets = preTargets[call];
+                    for (auto *callee: pre.targetsOf(call)) {
+                        if (!callee->isDeclaration()) {
+                            targets.insert(callee);
+                            preCalls.addEdge(&F, callee);
+                        }
+                    }
+                    if (targets.empty()) continue;
+                    accessNodes[&I] = newNode(NodeKind::Call, &I);
+                    returnNodes[call] = newNode(NodeKind::Return, &I);
+                    if (allocators.isAllocationCall(call))
+                        siteNodes[call] = addCopyNode(&I, std::set<MemLoc>{MemLoc(call, 0)},
+                                                      returnedBy(targets), INT64_MAX);
+                }
+            }
+        }
+    }
+
+    unsigned addCopyNode(Instruction *I, const std::set<MemLoc> &dests, const std::set<MemLoc> &sources,
+                         int64_t length) {
+        unsigned n = newNode(NodeKind::Access, I);
+        for (const auto &field: copiedFields(dests, sources, length)) {
+            nodes[n].defs.insert(field.first);
+            nodes[n].uses.insert(field.first);   // 弱更新，保留原来的内容
+            nodes[n].uses.insert(field.second);
+        }
+        return n;
+    }
+
+    /// What the pre-analysis says the callees may return.
+    std::set<MemLoc> returnedBy(const std::set<Function *> &callees) {
+        std::set<MemLoc> returned;
+        for (auto *callee: callees) {
+            for (auto &BB: *callee) {
+                auto *ret = dyn_cast<ReturnInst>(BB.getTerminator());
+                if (!ret || !ret->getReturnValue()) continue;
+                auto retPts = pre.pointsTo(ret->getReturnValue());
+                returned.insert(retPts.begin(), retPts.end());
+            }
+        }
+        return returned;
+    }
+
+    static bool isRealloc(CallInst *call) {
+        auto *callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+        return callee && callee->isDeclaration() && callee->getName() == "realloc";
+    }
+
+    /// Locations each function may access, itself or through its callees.
+    void computeModRef() {
+        auto addAccessed = [this](Instruction *I, unsigned n) {
+            auto &accessed = modRef[I->getFunction()];
+            accessed.insert(nodes[n].uses.begin(), nodes[n].uses.end());
+            accessed.insert(nodes[n].defs.begin(), nodes[n].defs.end());
+        };
+        for (const auto &it: accessNodes) {
+            addAccessed(it.first, it.second);
+        }
+        for (const auto &it: siteNodes) {
+            addAccessed(it.first, it.second);
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const auto &it: preTargets) {
+                auto &accessed = modRef[it.first->getFunction()];
+                for (auto *callee: it.second) {
+                    for (const auto &loc: modRef[callee]) {
+                        changed |= accessed.insert(loc).second;
+                    }
+                }
+            }
+        }
+
+        for (const auto &it: preTargets) {
+            if (it.second.empty()) continue;
+            std::set<MemLoc> accessed;
+            for (auto *callee: it.second) {
+                accessed.insert(modRef[callee].begin(), modRef[callee].end());
+            }
+            nodes[accessNodes[it.first]].uses = accessed;
+            nodes[returnNodes[it.first]].defs = accessed;
+        }
+        for (const auto &it: entryNodes) {
+            nodes[it.second].defs = modRef[it.first];
+            nodes[exitNodes[it.first]].uses = modRef[it.first];
+        }
+    }
+
+    /// Reaching definitions over one function's CFG; every use it meets gets
+    /// def-use edges from the definitions reaching it.
+    class DefUseVisitor : public DataflowVisitor<ReachingDefs> {
+    public:
+        DefUseVisitor(SparsePTA &owner, Function *fn) : owner(owner), fn(fn) {}
+
+        void merge(ReachingDefs *dest, const ReachingDefs &src) override {
+            for (const auto &it: src.defs) {
+                dest->defs[it.first].insert(it.second.begin(), it.second.end());
+            }
+        }
+
+        void compDFVal(Instruction *inst, ReachingDefs *dfVal) override {
+            if (isa<ReturnInst>(inst)) {
+                use(owner.exitNodes[fn], *dfVal);
+                return;
+            }
+            auto it = owner.accessNodes.find(inst);
+            if (it == owner.accessNodes.end()) return;
+            use(it->second, *dfVal);
+            unsigned def = it->second;
+            if (owner.nodes[def].kind == NodeKind::Call)
+                def = owner.returnNodes[cast<CallInst>(inst)];
+            define(def, dfVal);
+            auto site = owner.siteNodes.find(dyn_cast<CallInst>(inst));
+            if (site != owner.siteNodes.end()) {
+                use(site->second, *dfVal);
+                define(site->second, dfVal);
+            }
+        }
+
+        unsigned edges = 0;
+
+    private:
+        SparsePTA &owner;
+        Function *fn;
+
+        void define(unsigned n, ReachingDefs *dfVal) {
+            for (const auto &loc: owner.nodes[n].defs) {
+                dfVal->defs[loc] = std::set<unsigned>{n};
+            }
+        }
+
+        void use(unsigned n, const ReachingDefs &reaching) {
+            for (const auto &loc: owner.nodes[n].uses) {
+                auto it = reaching.defs.find(loc);
+                if (it == reaching.defs.end()) continue;
+                for (unsigned def: it->second) {
+                    edges += owner.addDefUse(def, n, loc);
+                }
+            }
+        }
+    };
+
+    /// @return true if the edge is new
+    bool addDefUse(unsigned def, unsigned use, const MemLoc &loc) {
+        auto &succs = nodes[def].succs[loc];
+        if (std::find(succs.begin(), succs.end(), use) != succs.end())
+            return false;
+        succs.push_back(use);
+        return true;
+    }
+
+    unsigned buildDefUse() {
+        unsigned edges = 0;
+        for (auto &F: module) {
+            if (F.isDeclaration()) continue;
+            ReachingDefs entryDefs, initVal;
+            for (const auto &loc: nodes[entryNodes[&F]].defs) {
+                entryDefs.defs[loc] = std::set<unsigned>{entryNodes[&F]};
+            }
+            DefUseVisitor visitor(*this, &F);
+            DataflowResult<ReachingDefs>::Type result;
+            compForwardDataflow(&F, &visitor, &result, initVal, entryDefs);
+            edges += visitor.edges;
+        }
+
+        // 调用点 -> callee入口，callee出口 -> 返回节点
+        for (const auto &it: preTargets) {
+            for (auto *callee: it.second) {
+                for (const auto &loc: modRef[callee]) {
+                    edges += addDefUse(accessNodes[it.first], entryNodes[callee], loc);
+                    edges += addDefUse(exitNodes[callee], returnNodes[it.first], loc);
+                }
+            }
+            // 不访问loc的callee原样返回调用前的内容
+            for (const auto &loc: nodes[returnNodes[it.first]].defs) {
+                for (auto *callee: it.second) {
+                    if (!modRef[callee].count(loc)) {
+                        edges += addDefUse(accessNodes[it.first], returnNodes[it.first], loc);
+                        break;
+                    }
+                }
+            }
+        }
+        return edges;
+    }
+
+    // ---------------------------------------------------------------------
+    // 第二阶段：沿def-use链的流敏感求解
+
+    void enqueue(Instruction *I) {
+        if (queuedInsts.insert(I).second)
+            instWorklist.push_back(I);
+    }
+
+    /// Content of loc after node n.
+    const std::set<MemLoc> &outOf(unsigned n, const MemLoc &loc) {
+        auto &node = nodes[n];
+        return node.kind == NodeKind::Access ? node.out[loc] : node.in[loc];
+    }
+
+    /// Add to node n's out, weakly: a node may be reevaluated before all of
+    /// its operands are known, and downstream nodes keep what they got anyway.
+    void defineOut(unsigned n, const MemLoc &loc, const std::set<MemLoc> &content) {
+        auto &out = nodes[n].out[loc];
+        size_t before = out.size();
+        out.insert(content.begin(), content.end());
+        if (out.size() != before)
+            memWorklist.emplace_back(n, loc);
+    }
+
+    /// The content of loc after n changed, hand it to n's uses.
+    void propagate(unsigned n, const MemLoc &loc) {
+        auto succs = nodes[n].succs.find(loc);
+        if (succs == nodes[n].succs.end()) return;
+        std::set<MemLoc> content = outOf(n, loc);
+        for (unsigned m: succs->second) {
+            auto &in = nodes[m].in[loc];
+            size_t before = in.size();
+            in.insert(content.begin(), content.end());
+            if (in.size() == before) continue;
+            if (nodes[m].kind == NodeKind::Access)
+                enqueue(nodes[m].inst);
+            else
+                memWorklist.emplace_back(m, loc);   // 其他节点原样传下去
+        }
+    }
+
+    bool addPts(Value *v, const std::set<MemLoc> &locs) {
+        auto &vPts = pts[v];
+        size_t before = vPts.size();
+        vPts.insert(locs.begin(), locs.end());
+        if (vPts.size() == before) return false;
+        for (auto *user: v->users()) {
+            if (auto *I = dyn_cast<Instruction>(user))
+                enqueue(I);
+        }
+        return true;
+    }
+
+    std::set<MemLoc> ptsOf(Value *v) {
+        if (auto *C = dyn_cast<Constant>(v))
+            return constantPts(C, module.getDataLayout());
+        auto it = pts.find(v);
+        return it == pts.end() ? std::set<MemLoc>{} : it->second;
+    }
+
+    void solve() {
+        for (auto &F: module) {
+            for (auto &I: instructions(F)) {
+                enqueue(&I);
+            }
+        }
+        unsigned root = entryNodes[entry];
+        for (const auto &loc: nodes[root].defs) {
+            if (auto *initial = globals.lookup(loc)) {
+                nodes[root].in[loc] = *initial;
+                memWorklist.emplace_back(root, loc);
+            }
+        }
+
+        while (!instWorklist.empty() || !memWorklist.empty()) {
+            while (!memWorklist.empty()) {
+                auto item = memWorklist.front();
+                memWorklist.pop_front();
+                propagate(item.first, item.second);
+            }
+            if (instWorklist.empty()) break;
+            Instruction *I = instWorklist.front();
+            instWorklist.pop_front();
+            queuedInsts.erase(I);
+            evalInstruction(I);
+        }
+    }
+
+    void evalInstruction(Instruction *I) {
+        if (!I->getType()->isPointerTy() && !isa<StoreInst>(I) && !isa<CallInst>(I) &&
+            !isa<ReturnInst>(I))
+            return;
+        if (auto *alloca = dyn_cast<AllocaInst>(I)) {
+            addPts(alloca, std::set<MemLoc>{MemLoc(alloca, 0)});
+        } else if (auto *gep = dyn_cast<GetElementPtrInst>(I)) {
+            const auto &DL = module.getDataLayout();
+            addPts(gep, shift(ptsOf(gep->getPointerOperand()), gepOffset(cast<GEPOperator>(gep), DL), DL));
+        } else if (isa<BitCastInst>(I) || isa<AddrSpaceCastInst>(I)) {
+            addPts(I, ptsOf(I->getOperand(0)));
+        } else if (auto *phi = dyn_cast<PHINode>(I)) {
+            for (Value *in: phi->incoming_values()) {
+                addPts(phi, ptsOf(in));
+            }
+        } else if (auto *select = dyn_cast<SelectInst>(I)) {
+            addPts(select, ptsOf(select->getTrueValue()));
+            addPts(select, ptsOf(select->getFalseValue()));
+        } else if (auto *load = dyn_cast<LoadInst>(I)) {
+            evalLoad(load);
+        } else if (auto *store = dyn_cast<StoreInst>(I)) {
+            evalStore(store);
+        } else if (auto *memCpy = dyn_cast<MemTransferInst>(I)) {
+            evalCopy(accessNodes[memCpy], ptsOf(memCpy->getRawDest()), ptsOf(memCpy->getRawSource()),
+                     lengthOf(memCpy));
+        } else if (auto *ret = dyn_cast<ReturnInst>(I)) {
+            evalReturn(ret);
+        } else if (auto *call = dyn_cast<CallInst>(I)) {
+            if (!isa<DbgInfoIntrinsic>(call) && !isa<MemIntrinsic>(call))
+                evalCall(call);
+        }
+    }
+
+    void evalLoad(LoadInst *load) {
+        auto it = accessNodes.find(load);
+        if (it == accessNodes.end()) return;
+        auto &in = nodes[it->second].in;
+        std::set<MemLoc> loaded;
+        for (const auto &loc: ptsOf(load->getPointerOperand())) {
+            auto content = in.find(loc);
+            if (content != in.end())
+                loaded.insert(content->second.begin(), content->second.end());
+        }
+        addPts(load, loaded);
+    }
+
+    void evalStore(StoreInst *store) {
+        auto it = accessNodes.find(store);
+        if (it == accessNodes.end()) return;
+        unsigned n = it->second;
+        auto targets = ptsOf(store->getPointerOperand());
+        if (targets.empty()) return;   // 等指针有了指向再求值，免得强更新之前先把旧内容传下去
+        auto value = ptsOf(store->getValueOperand());
+        for (const auto &loc: nodes[n].defs) {
+            if (targets.size() == 1 && targets.count(loc) && allowsStrongUpdate(loc)) {
+                defineOut(n, loc, value);    // 强更新
+                continue;
+            }
+            defineOut(n, loc, nodes[n].in[loc]);
+            if (targets.count(loc))
+                defineOut(n, loc, value);
+        }
+    }
+
+    /// Whether a store to loc may replace its contents: loc is exactly one
+    /// field of a single object at run time. Those are globals, allocas of
+    /// functions outside call cycles (only one frame of such a function is
+    /// live at a time, whatever calls share the analysis) and allocation
+    /// sites that run at most once. Other heap objects stand for every object
+    /// their site allocates.
+    bool allowsStrongUpdate(const MemLoc &loc) {
+        Value *obj = loc.first;
+        if (!hasExactFields(obj, module.getDataLayout()))
+            return false;
+        if (isa<GlobalVariable>(obj))
+            return true;
+        if (auto *alloca = dyn_cast<AllocaInst>(obj))
+            return !preCalls.isRecursive(alloca->getFunction());
+        auto *call = dyn_cast<CallInst>(obj);
+        return call && allocators.runsOnce(call);
+    }
+
+    /// memcpy/memmove and realloc: every field of the source range is added
+    /// to the same offset of the destination.
+    void evalCopy(unsigned n, const std::set<MemLoc> &dests, const std::set<MemLoc> &sources, int64_t length) {
+        for (const auto &loc: nodes[n].defs) {
+            defineOut(n, loc, nodes[n].in[loc]);
+        }
+        for (const auto &field: copiedFields(dests, sources, length)) {
+            if (nodes[n].defs.count(field.first))
+                defineOut(n, field.first, nodes[n].in[field.second]);
+        }
+    }
+
+    void evalReturn(ReturnInst *ret) {
+        Value *value = ret->getReturnValue();
+        if (!value || !value->getType()->isPointerTy()) return;
+        auto &fnPts = returnPts[ret->getFunction()];
+        size_t before = fnPts.size();
+        auto valuePts = ptsOf(value);
+        fnPts.insert(valuePts.begin(), valuePts.end());
+        if (fnPts.size() == before) return;
+        for (auto *call: callers[ret->getFunction()]) {
+            enqueue(call);
+        }
+    }
+
+    void evalCall(CallInst *call) {
+        if (isAllocationCall(call) && cast<Function>(call->getCalledOperand()->stripPointerCasts())->isDeclaration()) {
+            addPts(call, std::set<MemLoc>{MemLoc(call, 0)});
+            if (isRealloc(call))
+                evalCopy(accessNodes[call], std::set<MemLoc>{MemLoc(call, 0)}, ptsOf(call->getArgOperand(0)),
+                         INT64_MAX);
+            return;
+        }
+
+        for (auto *callee: targetsOf(call)) {
+            if (callee->isDeclaration()) continue;
+            callers[callee].insert(call);
+            for (unsigned i = 0, num = call->getNumArgOperands(); i < num && i < callee->arg_size(); ++i) {
+                if (call->getArgOperand(i)->getType()->isPointerTy())
+                    addPts(callee->getArg(i), ptsOf(call->getArgOperand(i)));
+            }
+            if (call->getType()->isPointerTy() && !siteNodes.count(call))
+                addPts(call, returnPts[callee]);
+        }
+        if (siteNodes.count(call))
+            evalAllocationSite(call);
+    }
+
+    /// A call to an allocation wrapper is its own object: what the wrapper
+    /// allocated is copied to it after the return, as PTAVisitor does.
+    void evalAllocationSite(CallInst *call) {
+        std::set<MemLoc> allocated;
+        for (auto *callee: targetsOf(call)) {
+            for (const auto &loc: returnPts[callee]) {
+                allocated.insert(MemLoc(loc.first, 0));
+            }
+        }
+        addPts(call, std::set<MemLoc>{MemLoc(call, 0)});
+        evalCopy(siteNodes[call], std::set<MemLoc>{MemLoc(call, 0)}, allocated, INT64_MAX);
+    }
+
+    /// Targets of call: its constant callee, or the functions the called
+    /// pointer points to, minus the ones whose signature can't match.
+    std::set<Function *> targetsOf(CallInst *call) {
+        std::set<Function *> targets;
+        for (const auto &loc: ptsOf(call->getCalledOperand())) {
+            auto *F = dyn_cast<Function>(loc.first);
+            if (F && loc.second == 0 && signatures.mayCall(call, F))
+                targets.insert(F);
+        }
+        return targets;
+    }
+};
+
+#endif //SPARSEPTA_H
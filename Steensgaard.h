@@ -0,0 +1,273 @@
+/************************************************************************
+ *
+ * @file Steensgaard.h
+ *
+ * Unification-based (Steensgaard) pointer analysis of the whole module
+ *
+ ***********************************************************************/
+
+#ifndef STEENSGAARD_H
+#define STEENSGAARD_H
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "GlobalInitializers.h"
+#include "MemoryModel.h"
+#include "PTA.h"
+#include "SignatureIndex.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Every SSA pointer and every abstract object (alloca, global, function,
+/// allocation site) is a cell of a union-find. A cell has at most one
+/// pointee cell, the class of everything it may point to, and the objects
+/// of a class share one pointee for their contents. Each assignment unifies
+/// the pointees of its two sides instead of adding an inclusion edge, so the
+/// whole module is processed in one pass over the instructions, in almost
+/// linear time and with one cell per value.
+///
+/// Fields are not distinguished: a GEP is a copy of its base. Indirect calls
+/// are bound to the functions in their callee's pointee class, which can grow
+/// with the bindings, so they are revisited until no new target shows up.
+/// The result over-approximates both other modes.
+///
+class SteensgaardPTA {
+public:
+    SteensgaardPTA(Module &M, Function *entry, unsigned threads)
+            : module(M), entry(entry), DL(M.getDataLayout()), signatures(M), globals(M, threads) {}
+
+    void run() {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &fact: globals.getFacts()) {
+            for (const auto &target: fact.second) {
+                join(contents(objectCell(fact.first.first)), objectCell(target.first));
+            }
+        }
+        for (auto &F: module) {
+            for (auto &I: instructions(F)) {
+                addInstruction(&I);
+            }
+        }
+
+        unsigned rounds = 0;
+        for (bool bound = true; bound; ++rounds) {
+            bound = false;
+            for (auto *call: indirectCalls) {
+                for (auto *F: targetsOf(call)) {
+                    bound |= bindCall(call, F);
+                }
+            }
+        }
+
+        reportReachableCalls(entry, [this](CallInst *call) { return targetsOf(call); }, &callResult);
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "Steensgaard: " << (int) cells.size() << " cells, " << (int) rounds
+             << " rounds of indirect calls, solved in " << (int) us << "us. \n";
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    static const unsigned None = ~0u;
+
+    struct Cell {
+        unsigned parent;
+        unsigned rank = 0;
+        unsigned pointee = None;       // 指向的等价类，None表示还不指向任何地方
+        std::set<Value *> objects;     // 类里的抽象对象，只在根上有效
+    };
+
+    Module &module;
+    Function *entry;
+    DataLayout DL;
+    SignatureIndex signatures;
+    GlobalInitializers globals;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+
+    std::vector<Cell> cells;
+    std::map<Value *, unsigned> valueCells;    // SSA指针 -> 单元
+    std::map<Value *, unsigned> objectCells;   // 抽象对象 -> 单元
+    std::vector<CallInst *> indirectCalls;
+    std::set<std::pair<CallInst *, Function *>> boundCalls;
+
+    unsigned newCell() {
+        cells.emplace_back();
+        cells.back().parent = cells.size() - 1;
+        return cells.size() - 1;
+    }
+
+    unsigned find(unsigned c) {
+        while (cells[c].parent != c) {
+            cells[c].parent = cells[cells[c].parent].parent;
+            c = cells[c].parent;
+        }
+        return c;
+    }
+
+    /// The class c points to, created empty on first use.
+    unsigned pointee(unsigned c) {
+        c = find(c);
+        if (cells[c].pointee == None) {
+            unsigned p = newCell();
+            cells[c].pointee = p;
+        }
+        return find(cells[c].pointee);
+    }
+
+    /// What the objects of obj's class hold.
+    unsigned contents(unsigned obj) {
+        return pointee(obj);
+    }
+
+    /// Unify the classes of a and b, and then their pointees, and so on.
+    void join(unsigned a, unsigned b) {
+        std::vector<std::pair<unsigned, unsigned>> pending{{a, b}};
+        while (!pending.empty()) {
+            unsigned x = find(pending.back().first);
+            unsigned y = find(pending.back().second);
+            pending.pop_back();
+            if (x == y) continue;
+            if (cells[x].rank < cells[y].rank)
+                std::swap(x, y);
+            if (cells[x].rank == cells[y].rank)
+                ++cells[x].rank;
+            cells[y].parent = x;
+
+            if (cells[x].objects.size() < cells[y].objects.size())
+                cells[x].objects.swap(cells[y].objects);
+            cells[x].objects.insert(cells[y].objects.begin(), cells[y].objects.end());
+            cells[y].objects.clear();
+
+            if (cells[x].pointee == None)
+                cells[x].pointee = cells[y].pointee;
+            else if (cells[y].pointee != None)
+                pending.emplace_back(cells[x].pointee, cells[y].pointee);
+        }
+    }
+
+    unsigned objectCell(Value *obj) {
+        auto it = objectCells.find(obj);
+        if (it != objectCells.end()) return it->second;
+        unsigned c = newCell();
+        cells[c].objects.insert(obj);
+        return objectCells[obj] = c;
+    }
+
+    /// Cell of an SSA pointer; a constant points to the objects it names.
+    unsigned valueCell(Value *v) {
+        auto it = valueCells.find(v);
+        if (it != valueCells.end()) return it->second;
+        unsigned c = valueCells[v] = newCell();
+        if (auto *C = dyn_cast<Constant>(v)) {
+            for (const auto &loc: constantPts(C, DL)) {
+                join(pointee(c), objectCell(loc.first));
+            }
+        }
+        return c;
+    }
+
+    /// dst = src: both point to the same class.
+    void copy(Value *src, Value *dst) {
+        join(pointee(valueCell(src)), pointee(valueCell(dst)));
+    }
+
+    void addInstruction(Instruction *I) {
+        if (isa<DbgInfoIntrinsic>(I)) return;
+        if (auto *alloca = dyn_cast<AllocaInst>(I)) {
+            join(pointee(valueCell(alloca)), objectCell(alloca));
+        } else if (auto *store = dyn_cast<StoreInst>(I)) {
+            if (store->getValueOperand()->getType()->isPointerTy())
+                join(contents(pointee(valueCell(store->getPointerOperand()))),
+                     pointee(valueCell(store->getValueOperand())));
+        } else if (auto *load = dyn_cast<LoadInst>(I)) {
+            if (load->getType()->isPointerTy())
+                join(pointee(valueCell(load)), contents(pointee(valueCell(load->getPointerOperand()))));
+        } else if (auto *gep = dyn_cast<GetElementPtrInst>(I)) {
+            copy(gep->getPointerOperand(), gep);   // 不区分字段
+        } else if (auto *memCpy = dyn_cast<MemTransferInst>(I)) {
+            join(contents(pointee(valueCell(memCpy->getRawDest()))),
+                 contents(pointee(valueCell(memCpy->getRawSource()))));
+        } else if (isa<BitCastInst>(I) || isa<AddrSpaceCastInst>(I)) {
+            if (I->getType()->isPointerTy())
+                copy(I->getOperand(0), I);
+        } else if (auto *phi = dyn_cast<PHINode>(I)) {
+            if (!phi->getType()->isPointerTy()) return;
+            for (Value *in: phi->incoming_values()) {
+                copy(in, phi);
+            }
+        } else if (auto *select = dyn_cast<SelectInst>(I)) {
+            if (!select->getType()->isPointerTy()) return;
+            copy(select->getTrueValue(), select);
+            copy(select->getFalseValue(), select);
+        } else if (auto *call = dyn_cast<CallInst>(I)) {
+            if (!isa<MemSetInst>(call))
+                addCall(call);
+        }
+    }
+
+    void addCall(CallInst *call) {
+        auto *callee = dyn_cast<Function>(call->getCalledOperand()->stripPointerCasts());
+        if (callee && callee->isDeclaration()) {
+            // C的分配函数：每个分配点是一个堆对象，realloc的结果和原来的块在同一个类里
+            if (isAllocationCall(call)) {
+                join(pointee(valueCell(call)), objectCell(call));
+                if (callee->getName() == "realloc")
+                    copy(call->getArgOperand(0), call);
+            }
+            return;
+        }
+        if (callee)
+            bindCall(call, callee);
+        else
+            indirectCalls.push_back(call);
+    }
+
+    /// @return true if call wasn't bound to F yet
+    bool bindCall(CallInst *call, Function *F) {
+        if (F->isDeclaration() || !boundCalls.insert({call, F}).second) return false;
+        for (unsigned i = 0, num = call->getNumArgOperands(); i < num && i < F->arg_size(); ++i) {
+            if (call->getArgOperand(i)->getType()->isPointerTy())
+                copy(call->getArgOperand(i), F->getArg(i));
+        }
+        if (call->getType()->isPointerTy()) {
+            for (auto &BB: *F) {
+                auto *ret = dyn_cast<ReturnInst>(BB.getTerminator());
+                if (ret && ret->getReturnValue())
+                    copy(ret->getReturnValue(), call);
+            }
+        }
+        return true;
+    }
+
+    /// Functions in the class the called pointer points to, minus the ones
+    /// whose signature can't match the call.
+    std::set<Function *> targetsOf(CallInst *call) {
+        std::set<Function *> targets;
+        for (auto *obj: cells[pointee(valueCell(call->getCalledOperand()))].objects) {
+            auto *F = dyn_cast<Function>(obj);
+            if (F && signatures.mayCall(call, F))
+                targets.insert(F);
+        }
+        return targets;
+    }
+};
+
+#endif //STEENSGAARD_H
@@ -0,0 +1,153 @@
+/************************************************************************
+ *
+ * @file ThreadPool.h
+ *
+ * Minimal fixed-size thread pool for the parallel analysis drivers
+ *
+ ***********************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    /// @threads number of workers, 0 for the hardware concurrency
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Queue a task. Tasks may queue further tasks.
+    void async(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push_back(std::move(task));
+            ++unfinished;
+        }
+        taskReady.notify_one();
+    }
+
+    /// Block until every queued task, including the ones queued by other
+    /// tasks, has finished.
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        allDone.wait(lock, [this] { return unfinished == 0; });
+    }
+
+    unsigned size() const {
+        return workers.size();
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    unsigned unfinished = 0;
+    bool stopping = false;
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--unfinished == 0)
+                    allDone.notify_all();
+            }
+        }
+    }
+};
+
+///
+/// Caps the number of extra threads that nested parallel sections may start.
+/// A task that can't get a thread runs on the calling thread, so sections can
+/// nest (a worker opening its own section) without deadlocking.
+///
+class ThreadBudget {
+public:
+    /// @threads total number of threads, 0 for the hardware concurrency
+    explicit ThreadBudget(unsigned threads = 0) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        spare = threads - 1;
+    }
+
+    /// Run all tasks and wait for them. The first one always runs on the
+    /// calling thread.
+    void invoke(std::vector<std::function<void()>> &tasks) {
+        std::vector<std::thread> started;
+        std::vector<size_t> deferred;
+        for (size_t i = 1; i < tasks.size(); ++i) {
+            if (tryAcquire()) {
+                started.emplace_back([this, &tasks, i] {
+                    tasks[i]();
+                    ++spare;
+                });
+            } else {
+                deferred.push_back(i);
+            }
+        }
+
+        if (!tasks.empty())
+            tasks[0]();
+        for (auto i: deferred) {
+            tasks[i]();
+        }
+        for (auto &thread: started) {
+            thread.join();
+        }
+    }
+
+private:
+    std::atomic<unsigned> spare;
+
+    bool tryAcquire() {
+        unsigned n = spare.load();
+        while (n > 0) {
+            if (spare.compare_exchange_weak(n, n - 1))
+                return true;
+        }
+        return false;
+    }
+};
+
+#endif //THREADPOOL_H
@@ -0,0 +1,161 @@
+/************************************************************************
+ *
+ * @file TieredPTA.h
+ *
+ * Tiered call-site resolution: cheap tiers first, the flow-sensitive
+ * analysis only when a reachable call site is still ambiguous
+ *
+ ***********************************************************************/
+
+#ifndef TIEREDPTA_H
+#define TIEREDPTA_H
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <chrono>
+#include <memory>
+
+#include "DemandPTA.h"
+#include "GlobalInitializers.h"
+#include "MemoryModel.h"
+#include "PTA.h"
+#include "PointerEquivalence.h"
+#include "SignatureIndex.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Resolves the call sites in three tiers, each one only looking at what the
+/// previous ones left ambiguous (more than one target):
+///   0. by type: constant callees, and indirect calls no address-taken
+///      function of a matching signature fits;
+///   1. flow-insensitively, with the demand-driven inclusion solver;
+///   2. the flow-sensitive PTAVisitor from the entry function.
+/// All tiers skip the code SCCP found unreachable, like the default mode. A
+/// single candidate of the right type is left to tier 1, which also sees
+/// whether the pointer is ever set. Tiers 0 and 1 over-approximate the
+/// flow-sensitive targets, so a site they resolve to a single target gets
+/// that target from tier 2 as well (unless the call is only ever reached
+/// before the pointer is set). If every call site reachable from the entry
+/// is resolved by then, tier 2 is skipped; else it runs as the default mode
+/// and its report is used as is.
+///
+class TieredPTA {
+public:
+    TieredPTA(Module &M, Function *entry, unsigned threads) : module(M), entry(entry), threads(threads) {}
+
+    void run() {
+        auto signatures = std::make_shared<SignatureIndex>(module);
+        equivalence = std::make_shared<PointerEquivalence>(module);
+        std::vector<CallInst *> ambiguous;
+
+        auto start = std::chrono::steady_clock::now();
+        DataLayout DL(module.getDataLayout());
+        unsigned sites = 0;
+        for (auto &F: module) {
+            for (auto &I: instructions(F)) {
+                auto *call = dyn_cast<CallInst>(&I);
+                if (!call || !isReportedCall(call) || !equivalence->isFeasible(call->getParent())) continue;
+                ++sites;
+                if (auto *C = dyn_cast<Constant>(call->getCalledOperand())) {
+                    auto &resolved = targets[call];
+                    for (const auto &loc: constantPts(C, DL)) {
+                        auto *callee = dyn_cast<Function>(loc.first);
+                        if (callee && loc.second == 0 && signatures->mayCall(call, callee))
+                            resolved.insert(callee);
+                    }
+                    continue;
+                }
+                // 唯一的候选也可能从没赋给过这个指针，留给第1层
+                if (signatures->candidates(call->getFunctionType()).empty())
+                    targets[call] = {};
+                else
+                    ambiguous.push_back(call);
+            }
+        }
+        logTier(0, start, sites - ambiguous.size(), sites);
+
+        start = std::chrono::steady_clock::now();
+        DemandResolver resolver(module);
+        resolver.setPointerEquivalence(equivalence);
+        std::set<CallInst *> unresolved;
+        for (auto *call: ambiguous) {
+            auto resolved = resolver.resolve(call);
+            if (resolved.size() <= 1)
+                targets[call] = resolved;
+            else
+                unresolved.insert(call);
+        }
+        logTier(1, start, ambiguous.size() - unresolved.size(), ambiguous.size());
+
+        if (!reachesAmbiguousCall(unresolved)) {
+            Info << "Tier 2 skipped, no ambiguous call site is reachable from " << entry->getName() << ". \n";
+            return;
+        }
+
+        start = std::chrono::steady_clock::now();
+        callResult.clear();
+        PTAVisitor visitor(&dfResult);
+        visitor.setSignatureIndex(signatures);
+        visitor.setGlobalInitializers(std::make_shared<GlobalInitializers>(module, threads));
+        visitor.setPointerEquivalence(equivalence);
+        visitor.analyzeFunction(entry, PTAInfo{});
+        callResult = visitor.getResults();
+        logTier(2, start, unresolved.size(), unresolved.size());
+    }
+
+    DataflowResult<PTAInfo>::Type &getDataflowResult() {
+        return dfResult;
+    }
+
+    const std::map<unsigned, std::set<std::string>> &getResults() const {
+        return callResult;
+    }
+
+private:
+    Module &module;
+    Function *entry;
+    unsigned threads;
+    std::shared_ptr<const PointerEquivalence> equivalence;
+    DataflowResult<PTAInfo>::Type dfResult;
+    std::map<unsigned, std::set<std::string>> callResult;
+    std::map<CallInst *, std::set<Function *>> targets;   // 前两层解析出来的调用点
+
+    /// Walk the functions reachable from the entry over the resolved targets
+    /// and report their call sites.
+    /// @return true if a reachable call site is in unresolved
+    bool reachesAmbiguousCall(const std::set<CallInst *> &unresolved) {
+        std::set<Function *> reached{entry};
+        std::vector<Function *> worklist{entry};
+        while (!worklist.empty()) {
+            Function *F = worklist.back();
+            worklist.pop_back();
+            for (auto &I: instructions(*F)) {
+                auto *call = dyn_cast<CallInst>(&I);
+                if (!call || !isReportedCall(call) || !equivalence->isFeasible(call->getParent())) continue;
+                if (unresolved.count(call))
+                    return true;
+                auto &names = callResult[call->getDebugLoc().getLine()];
+                for (auto *callee: targets[call]) {
+                    names.insert(callee->getName());
+                    if (!callee->isDeclaration() && reached.insert(callee).second)
+                        worklist.push_back(callee);
+                }
+            }
+        }
+        return false;
+    }
+
+    static void logTier(unsigned tier, std::chrono::steady_clock::time_point start,
+                        size_t resolved, size_t sites) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        Info << "Tier " << (int) tier << " resolved " << (int) resolved << " of " << (int) sites
+             << " call sites in " << (int) us << "us. \n";
+    }
+};
+
+#endif //TIEREDPTA_H
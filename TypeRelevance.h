@@ -0,0 +1,161 @@
+/************************************************************************
+ *
+ * @file TypeRelevance.h
+ *
+ * Which pointer values can lead to a function pointer, decided by type
+ *
+ ***********************************************************************/
+
+#ifndef TYPERELEVANCE_H
+#define TYPERELEVANCE_H
+
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "PointerEquivalence.h"
+#include "utils.h"
+
+using namespace llvm;
+
+///
+/// Marks every type of the module by whether a value of it can hold, or
+/// point to memory that may hold, a function pointer:
+///   - a pointer to a function, to i8 (C's generic pointer) or to an opaque
+///     struct is relevant, any other pointer if its pointee is;
+///   - a struct or array is relevant if one of its elements is;
+///   - scalars are not.
+/// Recursive structs are solved as a least fixpoint over all types.
+///
+/// A pointer SSA value of an irrelevant type (int *, double **, a buffer of
+/// numeric structs) is not tracked: the transfer functions neither bind its
+/// points-to set nor store it to memory. The exception is a value that is
+/// reinterpreted: cast to an integer, or cast (directly or through phis and
+/// selects) to a relevant pointer type stays tracked, and so does the
+/// representative of a class with a tracked member. The base of a tracked
+/// GEP is tracked too: a relevant field can be taken from an irrelevant
+/// object (a char buffer inside a numeric struct).
+///
+/// Everything is computed in the constructor, afterwards the index is
+/// read-only and can be shared between analysis threads.
+///
+class TypeRelevance {
+public:
+    TypeRelevance(Module &M, const PointerEquivalence &equivalence) {
+        for (auto &G: M.globals()) {
+            collect(G.getType());
+        }
+        for (auto &F: M) {
+            collect(F.getType());
+            for (auto &I: instructions(F)) {
+                collect(I.getType());
+                for (Value *op: I.operand_values()) {
+                    collect(op->getType());
+                }
+            }
+        }
+        solve();
+
+        unsigned pointers = 0;
+        for (auto &F: M) {
+            for (auto &arg: F.args()) {
+                pointers += classify(&arg);
+            }
+            for (auto &I: instructions(F)) {
+                pointers += classify(&I);
+            }
+        }
+
+        // 被重新解释成整数或者相关类型的值也要跟踪，等价类里有被跟踪的成员的代表元也是
+        std::vector<Value *> worklist;
+        for (auto &F: M) {
+            for (auto &I: instructions(F)) {
+                if (auto *toInt = dyn_cast<PtrToIntInst>(&I))
+                    track(toInt->getPointerOperand(), &worklist);
+                else if (I.getType()->isPointerTy() && isTracked(&I))
+                    worklist.push_back(&I);
+            }
+        }
+        while (!worklist.empty()) {
+            auto *I = dyn_cast<Instruction>(worklist.back());
+            worklist.pop_back();
+            if (!I) continue;
+            track(equivalence.rep(I), &worklist);
+            if (isa<BitCastInst>(I) || isa<AddrSpaceCastInst>(I) || isa<PHINode>(I) || isa<SelectInst>(I)) {
+                for (Value *op: I->operand_values()) {
+                    track(op, &worklist);
+                }
+            } else if (auto *gep = dyn_cast<GetElementPtrInst>(I)) {
+                track(gep->getPointerOperand(), &worklist);   // 无关类型的对象里也可能取出相关类型的字段
+            }
+        }
+        Info << "Type relevance: " << (int) untracked.size() << " of " << (int) pointers
+             << " pointer values not tracked. \n";
+    }
+
+    /// @return true if type can lead to a function pointer
+    bool isRelevant(Type *type) const {
+        auto it = relevant.find(type);
+        return it == relevant.end() || it->second;
+    }
+
+    /// @return false if v's points-to set can be left out of the state
+    bool isTracked(Value *v) const {
+        return untracked.count(v) == 0;
+    }
+
+private:
+    std::map<Type *, bool> relevant;
+    std::set<Value *> untracked;   // 类型无关的指针值
+
+    void collect(Type *type) {
+        if (!relevant.emplace(type, false).second) return;
+        if (auto *ptr = dyn_cast<PointerType>(type))
+            collect(ptr->getElementType());
+        for (Type *element: type->subtypes()) {
+            collect(element);
+        }
+    }
+
+    void solve() {
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto &it: relevant) {
+                if (it.second) continue;
+                Type *type = it.first;
+                bool now = false;
+                if (auto *ptr = dyn_cast<PointerType>(type)) {
+                    Type *pointee = ptr->getElementType();
+                    auto *st = dyn_cast<StructType>(pointee);
+                    now = pointee->isFunctionTy() || pointee->isIntegerTy(8) || (st && st->isOpaque()) ||
+                          relevant[pointee];
+                } else if (type->isStructTy() || type->isArrayTy() || type->isVectorTy()) {
+                    for (Type *element: type->subtypes()) {
+                        now |= relevant[element];
+                    }
+                }
+                if (now)
+                    it.second = changed = true;
+            }
+        }
+    }
+
+    /// @return 1 if v is a pointer
+    unsigned classify(Value *v) {
+        if (!v->getType()->isPointerTy()) return 0;
+        if (!isRelevant(v->getType()))
+            untracked.insert(v);
+        return 1;
+    }
+
+    void track(Value *v, std::vector<Value *> *worklist) {
+        if (untracked.erase(v))
+            worklist->push_back(v);
+    }
+};
+
+#endif //TYPERELEVANCE_H
@@ -0,0 +1,64 @@
+; ModuleID = 'test35.bc'
+source_filename = "test35.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.fptr = type { i32 (i32, i32)*, [16 x i8] }
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @foo(i32 %n) !dbg !103 {
+entry:
+  %a_fptr = alloca %struct.fptr, align 8
+  %p_fptr = getelementptr inbounds %struct.fptr, %struct.fptr* %a_fptr, i32 0, i32 0, !dbg !104
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %p_fptr, align 8, !dbg !105
+  %0 = bitcast %struct.fptr* %a_fptr to i8*, !dbg !106
+  br label %for.cond, !dbg !107
+
+for.cond:
+  %p = phi i8* [ %0, %entry ], [ %incdec.ptr, %for.inc ]
+  %i = phi i32 [ 0, %entry ], [ %inc, %for.inc ]
+  %cmp = icmp slt i32 %i, %n, !dbg !108
+  br i1 %cmp, label %for.inc, label %for.end, !dbg !109
+
+for.inc:
+  %incdec.ptr = getelementptr inbounds i8, i8* %p, i32 1, !dbg !110
+  %inc = add nsw i32 %i, 1, !dbg !111
+  br label %for.cond, !dbg !112
+
+for.end:
+  %1 = bitcast i8* %p to i32 (i32, i32)**, !dbg !113
+  %2 = load i32 (i32, i32)*, i32 (i32, i32)** %1, align 8, !dbg !114
+  %call = call i32 %2(i32 1, i32 %n), !dbg !115
+  ret i32 %call, !dbg !116
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test35.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 7, type: !5, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 8, column: 3, scope: !100)
+!102 = !DILocation(line: 8, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 11, type: !5, scopeLine: 11, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 14, column: 3, scope: !103)
+!105 = !DILocation(line: 14, column: 3, scope: !103)
+!106 = !DILocation(line: 15, column: 3, scope: !103)
+!107 = !DILocation(line: 16, column: 3, scope: !103)
+!108 = !DILocation(line: 16, column: 3, scope: !103)
+!109 = !DILocation(line: 16, column: 3, scope: !103)
+!110 = !DILocation(line: 17, column: 3, scope: !103)
+!111 = !DILocation(line: 16, column: 3, scope: !103)
+!112 = !DILocation(line: 16, column: 3, scope: !103)
+!113 = !DILocation(line: 18, column: 3, scope: !103)
+!114 = !DILocation(line: 19, column: 3, scope: !103)
+!115 = !DILocation(line: 19, column: 3, scope: !103)
+!116 = !DILocation(line: 19, column: 3, scope: !103)
@@ -0,0 +1,140 @@
+; ModuleID = 'test36.bc'
+source_filename = "test36.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.node = type { i32 (i32, i32)*, %struct.node* }
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @times(i32 %a, i32 %b) !dbg !106 {
+entry:
+  %mul = mul nsw i32 %a, %b, !dbg !107
+  ret i32 %mul, !dbg !108
+}
+
+define dso_local i32 @apply(i32 %n, %struct.node* %list) !dbg !109 {
+entry:
+  %cmp = icmp sgt i32 %n, 0, !dbg !110
+  br i1 %cmp, label %if.then, label %if.end, !dbg !111
+
+if.then:
+  %call = call %struct.node* @walk(i32 %n, %struct.node* %list), !dbg !112
+  %p_fptr = getelementptr inbounds %struct.node, %struct.node* %call, i32 0, i32 0, !dbg !113
+  %0 = load i32 (i32, i32)*, i32 (i32, i32)** %p_fptr, align 8, !dbg !114
+  %call1 = call i32 %0(i32 1, i32 %n), !dbg !115
+  br label %return, !dbg !116
+
+if.end:
+  br label %return, !dbg !117
+
+return:
+  %retval = phi i32 [ %call1, %if.then ], [ 0, %if.end ]
+  ret i32 %retval, !dbg !118
+}
+
+define dso_local %struct.node* @walk(i32 %n, %struct.node* %list) !dbg !119 {
+entry:
+  %cmp = icmp eq i32 %n, 0, !dbg !120
+  br i1 %cmp, label %if.then, label %if.end, !dbg !121
+
+if.then:
+  %call = call i32 @apply(i32 %n, %struct.node* %list), !dbg !122
+  br label %return, !dbg !123
+
+if.end:
+  %sub = sub nsw i32 %n, 1, !dbg !124
+  %call1 = call %struct.node* @walk(i32 %sub, %struct.node* %list), !dbg !125
+  %next = getelementptr inbounds %struct.node, %struct.node* %call1, i32 0, i32 1, !dbg !126
+  %0 = load %struct.node*, %struct.node** %next, align 8, !dbg !127
+  br label %return, !dbg !128
+
+return:
+  %retval = phi %struct.node* [ %list, %if.then ], [ %0, %if.end ]
+  ret %struct.node* %retval, !dbg !129
+}
+
+define dso_local i32 @foo(i32 %n) !dbg !130 {
+entry:
+  %c = alloca %struct.node, align 8
+  %b = alloca %struct.node, align 8
+  %a = alloca %struct.node, align 8
+  %c.fptr = getelementptr inbounds %struct.node, %struct.node* %c, i32 0, i32 0, !dbg !131
+  store i32 (i32, i32)* @times, i32 (i32, i32)** %c.fptr, align 8, !dbg !132
+  %c.next = getelementptr inbounds %struct.node, %struct.node* %c, i32 0, i32 1, !dbg !133
+  store %struct.node* null, %struct.node** %c.next, align 8, !dbg !134
+  %b.fptr = getelementptr inbounds %struct.node, %struct.node* %b, i32 0, i32 0, !dbg !135
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %b.fptr, align 8, !dbg !136
+  %b.next = getelementptr inbounds %struct.node, %struct.node* %b, i32 0, i32 1, !dbg !137
+  store %struct.node* %c, %struct.node** %b.next, align 8, !dbg !138
+  %a.fptr = getelementptr inbounds %struct.node, %struct.node* %a, i32 0, i32 0, !dbg !139
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %a.fptr, align 8, !dbg !140
+  %a.next = getelementptr inbounds %struct.node, %struct.node* %a, i32 0, i32 1, !dbg !141
+  store %struct.node* %b, %struct.node** %a.next, align 8, !dbg !142
+  %call = call i32 @apply(i32 %n, %struct.node* %a), !dbg !143
+  ret i32 %call, !dbg !144
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test36.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 7, type: !5, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 8, column: 3, scope: !100)
+!102 = !DILocation(line: 8, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 11, type: !5, scopeLine: 11, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 12, column: 3, scope: !103)
+!105 = !DILocation(line: 12, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "times", scope: !1, file: !1, line: 15, type: !5, scopeLine: 15, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 16, column: 3, scope: !106)
+!108 = !DILocation(line: 16, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "apply", scope: !1, file: !1, line: 21, type: !5, scopeLine: 21, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 23, column: 3, scope: !109)
+!111 = !DILocation(line: 23, column: 3, scope: !109)
+!112 = !DILocation(line: 25, column: 3, scope: !109)
+!113 = !DILocation(line: 26, column: 3, scope: !109)
+!114 = !DILocation(line: 26, column: 3, scope: !109)
+!115 = !DILocation(line: 26, column: 3, scope: !109)
+!116 = !DILocation(line: 26, column: 3, scope: !109)
+!117 = !DILocation(line: 28, column: 3, scope: !109)
+!118 = !DILocation(line: 29, column: 3, scope: !109)
+!119 = distinct !DISubprogram(name: "walk", scope: !1, file: !1, line: 31, type: !5, scopeLine: 31, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!120 = !DILocation(line: 33, column: 3, scope: !119)
+!121 = !DILocation(line: 33, column: 3, scope: !119)
+!122 = !DILocation(line: 35, column: 3, scope: !119)
+!123 = !DILocation(line: 36, column: 3, scope: !119)
+!124 = !DILocation(line: 38, column: 3, scope: !119)
+!125 = !DILocation(line: 38, column: 3, scope: !119)
+!126 = !DILocation(line: 39, column: 3, scope: !119)
+!127 = !DILocation(line: 39, column: 3, scope: !119)
+!128 = !DILocation(line: 39, column: 3, scope: !119)
+!129 = !DILocation(line: 40, column: 3, scope: !119)
+!130 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 42, type: !5, scopeLine: 42, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!131 = !DILocation(line: 45, column: 3, scope: !130)
+!132 = !DILocation(line: 45, column: 3, scope: !130)
+!133 = !DILocation(line: 46, column: 3, scope: !130)
+!134 = !DILocation(line: 46, column: 3, scope: !130)
+!135 = !DILocation(line: 48, column: 3, scope: !130)
+!136 = !DILocation(line: 48, column: 3, scope: !130)
+!137 = !DILocation(line: 49, column: 3, scope: !130)
+!138 = !DILocation(line: 49, column: 3, scope: !130)
+!139 = !DILocation(line: 51, column: 3, scope: !130)
+!140 = !DILocation(line: 51, column: 3, scope: !130)
+!141 = !DILocation(line: 52, column: 3, scope: !130)
+!142 = !DILocation(line: 52, column: 3, scope: !130)
+!143 = !DILocation(line: 53, column: 3, scope: !130)
+!144 = !DILocation(line: 53, column: 3, scope: !130)
@@ -0,0 +1,115 @@
+; ModuleID = 'test37.bc'
+source_filename = "test37.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.fptr = type { i32 (i32, i32)* }
+
+@last = common dso_local global %struct.fptr* null, align 8
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local void @remember(%struct.fptr* %p) !dbg !106 {
+entry:
+  store %struct.fptr* %p, %struct.fptr** @last, align 8, !dbg !107
+  ret void, !dbg !108
+}
+
+define dso_local %struct.fptr* @make() !dbg !109 {
+entry:
+  %call = call noalias i8* @malloc(i64 8), !dbg !110
+  %0 = bitcast i8* %call to %struct.fptr*, !dbg !111
+  ret %struct.fptr* %0, !dbg !112
+}
+
+define dso_local %struct.fptr* @make_shared() !dbg !113 {
+entry:
+  %call = call noalias i8* @malloc(i64 8), !dbg !114
+  %0 = bitcast i8* %call to %struct.fptr*, !dbg !115
+  call void @remember(%struct.fptr* %0), !dbg !116
+  ret %struct.fptr* %0, !dbg !117
+}
+
+declare dso_local noalias i8* @malloc(i64)
+
+define dso_local i32 @foo(i32 %x) !dbg !118 {
+entry:
+  %call = call %struct.fptr* @make(), !dbg !119
+  %p_fptr = getelementptr inbounds %struct.fptr, %struct.fptr* %call, i32 0, i32 0, !dbg !120
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %p_fptr, align 8, !dbg !121
+  %call1 = call %struct.fptr* @make(), !dbg !122
+  %p_fptr2 = getelementptr inbounds %struct.fptr, %struct.fptr* %call1, i32 0, i32 0, !dbg !123
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %p_fptr2, align 8, !dbg !124
+  %p_fptr3 = getelementptr inbounds %struct.fptr, %struct.fptr* %call, i32 0, i32 0, !dbg !125
+  %0 = load i32 (i32, i32)*, i32 (i32, i32)** %p_fptr3, align 8, !dbg !126
+  %call4 = call i32 %0(i32 1, i32 %x), !dbg !127
+  %call5 = call %struct.fptr* @make_shared(), !dbg !128
+  %p_fptr6 = getelementptr inbounds %struct.fptr, %struct.fptr* %call5, i32 0, i32 0, !dbg !129
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %p_fptr6, align 8, !dbg !130
+  %call7 = call %struct.fptr* @make_shared(), !dbg !131
+  %p_fptr8 = getelementptr inbounds %struct.fptr, %struct.fptr* %call7, i32 0, i32 0, !dbg !132
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %p_fptr8, align 8, !dbg !133
+  %1 = load %struct.fptr*, %struct.fptr** @last, align 8, !dbg !134
+  %p_fptr9 = getelementptr inbounds %struct.fptr, %struct.fptr* %1, i32 0, i32 0, !dbg !135
+  %2 = load i32 (i32, i32)*, i32 (i32, i32)** %p_fptr9, align 8, !dbg !136
+  %call10 = call i32 %2(i32 1, i32 %x), !dbg !137
+  ret i32 %call10, !dbg !138
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test37.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 6, type: !5, scopeLine: 6, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 7, column: 3, scope: !100)
+!102 = !DILocation(line: 7, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 10, type: !5, scopeLine: 10, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 11, column: 3, scope: !103)
+!105 = !DILocation(line: 11, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "remember", scope: !1, file: !1, line: 16, type: !5, scopeLine: 16, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 18, column: 3, scope: !106)
+!108 = !DILocation(line: 19, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "make", scope: !1, file: !1, line: 21, type: !5, scopeLine: 21, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 23, column: 3, scope: !109)
+!111 = !DILocation(line: 23, column: 3, scope: !109)
+!112 = !DILocation(line: 24, column: 3, scope: !109)
+!113 = distinct !DISubprogram(name: "make_shared", scope: !1, file: !1, line: 27, type: !5, scopeLine: 27, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!114 = !DILocation(line: 29, column: 3, scope: !113)
+!115 = !DILocation(line: 29, column: 3, scope: !113)
+!116 = !DILocation(line: 30, column: 3, scope: !113)
+!117 = !DILocation(line: 31, column: 3, scope: !113)
+!118 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 34, type: !5, scopeLine: 34, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!119 = !DILocation(line: 36, column: 3, scope: !118)
+!120 = !DILocation(line: 37, column: 3, scope: !118)
+!121 = !DILocation(line: 37, column: 3, scope: !118)
+!122 = !DILocation(line: 38, column: 3, scope: !118)
+!123 = !DILocation(line: 39, column: 3, scope: !118)
+!124 = !DILocation(line: 39, column: 3, scope: !118)
+!125 = !DILocation(line: 40, column: 3, scope: !118)
+!126 = !DILocation(line: 40, column: 3, scope: !118)
+!127 = !DILocation(line: 40, column: 3, scope: !118)
+!128 = !DILocation(line: 41, column: 3, scope: !118)
+!129 = !DILocation(line: 42, column: 3, scope: !118)
+!130 = !DILocation(line: 42, column: 3, scope: !118)
+!131 = !DILocation(line: 43, column: 3, scope: !118)
+!132 = !DILocation(line: 44, column: 3, scope: !118)
+!133 = !DILocation(line: 44, column: 3, scope: !118)
+!134 = !DILocation(line: 45, column: 3, scope: !118)
+!135 = !DILocation(line: 45, column: 3, scope: !118)
+!136 = !DILocation(line: 45, column: 3, scope: !118)
+!137 = !DILocation(line: 45, column: 3, scope: !118)
+!138 = !DILocation(line: 45, column: 3, scope: !118)
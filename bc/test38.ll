@@ -0,0 +1,95 @@
+; ModuleID = 'test38.bc'
+source_filename = "test38.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.ops = type { i32 (i32, i32)* }
+
+@table = dso_local global %struct.ops { i32 (i32, i32)* @times }, align 8
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @times(i32 %a, i32 %b) !dbg !106 {
+entry:
+  %mul = mul nsw i32 %a, %b, !dbg !107
+  ret i32 %mul, !dbg !108
+}
+
+define dso_local void @set(%struct.ops* %o, i32 (i32, i32)* %f) !dbg !109 {
+entry:
+  %op = getelementptr inbounds %struct.ops, %struct.ops* %o, i32 0, i32 0, !dbg !110
+  store i32 (i32, i32)* %f, i32 (i32, i32)** %op, align 8, !dbg !111
+  ret void, !dbg !112
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !113 {
+entry:
+  %local = alloca %struct.ops, align 8
+  %shared = alloca %struct.ops, align 8
+  %copy = alloca %struct.ops, align 8
+  %op = getelementptr inbounds %struct.ops, %struct.ops* %local, i32 0, i32 0, !dbg !114
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %op, align 8, !dbg !115
+  call void @set(%struct.ops* %shared, i32 (i32, i32)* @minus), !dbg !116
+  %0 = bitcast %struct.ops* %copy to i8*, !dbg !117
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* align 8 %0, i8* align 8 bitcast (%struct.ops* @table to i8*), i64 8, i1 false), !dbg !118
+  %op1 = getelementptr inbounds %struct.ops, %struct.ops* %local, i32 0, i32 0, !dbg !119
+  %1 = load i32 (i32, i32)*, i32 (i32, i32)** %op1, align 8, !dbg !120
+  %2 = call i32 %1(i32 1, i32 %x), !dbg !121
+  %op2 = getelementptr inbounds %struct.ops, %struct.ops* %shared, i32 0, i32 0, !dbg !122
+  %3 = load i32 (i32, i32)*, i32 (i32, i32)** %op2, align 8, !dbg !123
+  %call5 = call i32 %3(i32 1, i32 %2), !dbg !124
+  %op3 = getelementptr inbounds %struct.ops, %struct.ops* %copy, i32 0, i32 0, !dbg !125
+  %4 = load i32 (i32, i32)*, i32 (i32, i32)** %op3, align 8, !dbg !126
+  %call6 = call i32 %4(i32 1, i32 %call5), !dbg !127
+  ret i32 %call6, !dbg !128
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8* noalias nocapture writeonly, i8* noalias nocapture readonly, i64, i1 immarg)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test38.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 7, type: !5, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 8, column: 3, scope: !100)
+!102 = !DILocation(line: 8, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 11, type: !5, scopeLine: 11, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 12, column: 3, scope: !103)
+!105 = !DILocation(line: 12, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "times", scope: !1, file: !1, line: 15, type: !5, scopeLine: 15, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 16, column: 3, scope: !106)
+!108 = !DILocation(line: 16, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "set", scope: !1, file: !1, line: 21, type: !5, scopeLine: 21, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 23, column: 3, scope: !109)
+!111 = !DILocation(line: 23, column: 3, scope: !109)
+!112 = !DILocation(line: 24, column: 3, scope: !109)
+!113 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 26, type: !5, scopeLine: 26, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!114 = !DILocation(line: 29, column: 3, scope: !113)
+!115 = !DILocation(line: 29, column: 3, scope: !113)
+!116 = !DILocation(line: 31, column: 3, scope: !113)
+!117 = !DILocation(line: 33, column: 3, scope: !113)
+!118 = !DILocation(line: 33, column: 3, scope: !113)
+!119 = !DILocation(line: 34, column: 4, scope: !113)
+!120 = !DILocation(line: 34, column: 4, scope: !113)
+!121 = !DILocation(line: 34, column: 4, scope: !113)
+!122 = !DILocation(line: 35, column: 4, scope: !113)
+!123 = !DILocation(line: 35, column: 4, scope: !113)
+!124 = !DILocation(line: 35, column: 4, scope: !113)
+!125 = !DILocation(line: 36, column: 9, scope: !113)
+!126 = !DILocation(line: 36, column: 9, scope: !113)
+!127 = !DILocation(line: 36, column: 9, scope: !113)
+!128 = !DILocation(line: 36, column: 3, scope: !113)
@@ -0,0 +1,87 @@
+; ModuleID = 'test39.bc'
+source_filename = "test39.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+@hook = common dso_local global void (i32)* null, align 8
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local void @trace(i32 %x) !dbg !106 {
+entry:
+  ret void, !dbg !107
+}
+
+define dso_local i32 @twice(i32 (i32, i32)* %f, i32 %x) !dbg !108 {
+entry:
+  %call = call i32 %f(i32 %x, i32 %x), !dbg !109
+  ret i32 %call, !dbg !110
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !111 {
+entry:
+  %tobool = icmp ne i32 0, 0, !dbg !112
+  br i1 %tobool, label %if.then, label %if.end, !dbg !113
+
+if.then:
+  store void (i32)* @trace, void (i32)** @hook, align 8, !dbg !114
+  %call = call i32 @minus(i32 1, i32 %x), !dbg !115
+  br label %if.end, !dbg !116
+
+if.end:
+  %x.addr.0 = phi i32 [ %call, %if.then ], [ %x, %entry ]
+  %call1 = call i32 @twice(i32 (i32, i32)* @plus, i32 %x.addr.0), !dbg !117
+  %cmp = icmp sgt i32 %call1, 2, !dbg !118
+  br i1 %cmp, label %if.then2, label %if.end3, !dbg !119
+
+if.then2:
+  %0 = load void (i32)*, void (i32)** @hook, align 8, !dbg !120
+  call void %0(i32 %call1), !dbg !121
+  br label %if.end3, !dbg !122
+
+if.end3:
+  ret i32 %call1, !dbg !123
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test39.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "trace", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 11, column: 3, scope: !106)
+!108 = distinct !DISubprogram(name: "twice", scope: !1, file: !1, line: 15, type: !5, scopeLine: 15, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!109 = !DILocation(line: 17, column: 3, scope: !108)
+!110 = !DILocation(line: 17, column: 3, scope: !108)
+!111 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 20, type: !5, scopeLine: 20, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!112 = !DILocation(line: 23, column: 3, scope: !111)
+!113 = !DILocation(line: 23, column: 3, scope: !111)
+!114 = !DILocation(line: 25, column: 3, scope: !111)
+!115 = !DILocation(line: 26, column: 3, scope: !111)
+!116 = !DILocation(line: 27, column: 3, scope: !111)
+!117 = !DILocation(line: 28, column: 3, scope: !111)
+!118 = !DILocation(line: 29, column: 3, scope: !111)
+!119 = !DILocation(line: 29, column: 3, scope: !111)
+!120 = !DILocation(line: 30, column: 3, scope: !111)
+!121 = !DILocation(line: 30, column: 3, scope: !111)
+!122 = !DILocation(line: 30, column: 3, scope: !111)
+!123 = !DILocation(line: 31, column: 3, scope: !111)
@@ -0,0 +1,84 @@
+; ModuleID = 'test40.bc'
+source_filename = "test40.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @twice(i32 %x) !dbg !106 {
+entry:
+  %call = call i32 @plus(i32 %x, i32 %x), !dbg !107
+  ret i32 %call, !dbg !108
+}
+
+define dso_local i32 @count(i32 %x) !dbg !109 {
+entry:
+  %tobool = icmp ne i32 0, 0, !dbg !110
+  br i1 %tobool, label %if.then, label %if.end, !dbg !111
+
+if.then:
+  %call = call i32 @twice(i32 %x), !dbg !112
+  br label %if.end, !dbg !113
+
+if.end:
+  %x.addr.0 = phi i32 [ %call, %if.then ], [ %x, %entry ]
+  %call1 = call i32 @minus(i32 %x.addr.0, i32 1), !dbg !114
+  ret i32 %call1, !dbg !115
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !116 {
+entry:
+  %cmp = icmp sgt i32 %x, 1, !dbg !117
+  br i1 %cmp, label %if.then, label %if.end, !dbg !118
+
+if.then:
+  br label %if.end, !dbg !119
+
+if.end:
+  %f.0 = phi i32 (i32, i32)* [ @minus, %if.then ], [ @plus, %entry ]
+  %call = call i32 @count(i32 %x), !dbg !120
+  %call1 = call i32 %f.0(i32 1, i32 %call), !dbg !121
+  ret i32 %call1, !dbg !122
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test40.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "twice", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 11, column: 3, scope: !106)
+!108 = !DILocation(line: 11, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "count", scope: !1, file: !1, line: 14, type: !5, scopeLine: 14, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 17, column: 3, scope: !109)
+!111 = !DILocation(line: 17, column: 3, scope: !109)
+!112 = !DILocation(line: 18, column: 3, scope: !109)
+!113 = !DILocation(line: 18, column: 3, scope: !109)
+!114 = !DILocation(line: 19, column: 3, scope: !109)
+!115 = !DILocation(line: 19, column: 3, scope: !109)
+!116 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 22, type: !5, scopeLine: 22, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!117 = !DILocation(line: 25, column: 3, scope: !116)
+!118 = !DILocation(line: 25, column: 3, scope: !116)
+!119 = !DILocation(line: 26, column: 3, scope: !116)
+!120 = !DILocation(line: 27, column: 3, scope: !116)
+!121 = !DILocation(line: 28, column: 3, scope: !116)
+!122 = !DILocation(line: 28, column: 3, scope: !116)
@@ -0,0 +1,113 @@
+; ModuleID = 'test41.bc'
+source_filename = "test41.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.table = type { i32, %struct.ops }
+%struct.ops = type { i32 (i32, i32)*, i32 (i32, i32)* }
+
+@calc = dso_local global %struct.table { i32 1, %struct.ops { i32 (i32, i32)* @plus, i32 (i32, i32)* @minus } }, align 8
+@current = dso_local global %struct.ops* getelementptr inbounds (%struct.table, %struct.table* @calc, i32 0, i32 1), align 8
+@steps = dso_local global [2 x i32 (i32, i32)*] [i32 (i32, i32)* @times, i32 (i32, i32)* @plus], align 16
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @times(i32 %a, i32 %b) !dbg !106 {
+entry:
+  %mul = mul nsw i32 %a, %b, !dbg !107
+  ret i32 %mul, !dbg !108
+}
+
+define dso_local void @reset() !dbg !109 {
+entry:
+  store i32 (i32, i32)* @times, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @calc, i32 0, i32 1, i32 1), align 8, !dbg !110
+  ret void, !dbg !111
+}
+
+define dso_local void @keep() !dbg !112 {
+entry:
+  ret void, !dbg !113
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !114 {
+entry:
+  %0 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @calc, i32 0, i32 1, i32 1), align 8, !dbg !115
+  %call = call i32 %0(i32 1, i32 %x), !dbg !116
+  %1 = load %struct.ops*, %struct.ops** @current, align 8, !dbg !117
+  %first = getelementptr inbounds %struct.ops, %struct.ops* %1, i32 0, i32 0, !dbg !118
+  %2 = load i32 (i32, i32)*, i32 (i32, i32)** %first, align 8, !dbg !119
+  %call1 = call i32 %2(i32 1, i32 %call), !dbg !120
+  %cmp = icmp sgt i32 %call1, 1, !dbg !121
+  br i1 %cmp, label %if.then, label %if.end, !dbg !122
+
+if.then:
+  %3 = load %struct.ops*, %struct.ops** @current, align 8, !dbg !123
+  %first2 = getelementptr inbounds %struct.ops, %struct.ops* %3, i32 0, i32 0, !dbg !124
+  store i32 (i32, i32)* @times, i32 (i32, i32)** %first2, align 8, !dbg !125
+  br label %if.end, !dbg !126
+
+if.end:
+  %update.0 = phi void ()* [ @reset, %if.then ], [ @keep, %entry ]
+  %4 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @calc, i32 0, i32 1, i32 0), align 8, !dbg !127
+  %call3 = call i32 %4(i32 1, i32 %call1), !dbg !128
+  call void %update.0(), !dbg !129
+  %5 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @calc, i32 0, i32 1, i32 1), align 8, !dbg !130
+  %call4 = call i32 %5(i32 1, i32 %call3), !dbg !131
+  %6 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds ([2 x i32 (i32, i32)*], [2 x i32 (i32, i32)*]* @steps, i64 0, i64 1), align 8, !dbg !132
+  %call5 = call i32 %6(i32 1, i32 %call4), !dbg !133
+  ret i32 %call5, !dbg !134
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test41.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "times", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 10, column: 3, scope: !106)
+!108 = !DILocation(line: 10, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "reset", scope: !1, file: !1, line: 29, type: !5, scopeLine: 29, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 31, column: 3, scope: !109)
+!111 = !DILocation(line: 32, column: 3, scope: !109)
+!112 = distinct !DISubprogram(name: "keep", scope: !1, file: !1, line: 34, type: !5, scopeLine: 34, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!113 = !DILocation(line: 36, column: 3, scope: !112)
+!114 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 38, type: !5, scopeLine: 38, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!115 = !DILocation(line: 41, column: 3, scope: !114)
+!116 = !DILocation(line: 41, column: 3, scope: !114)
+!117 = !DILocation(line: 42, column: 3, scope: !114)
+!118 = !DILocation(line: 42, column: 3, scope: !114)
+!119 = !DILocation(line: 42, column: 3, scope: !114)
+!120 = !DILocation(line: 42, column: 3, scope: !114)
+!121 = !DILocation(line: 43, column: 3, scope: !114)
+!122 = !DILocation(line: 43, column: 3, scope: !114)
+!123 = !DILocation(line: 45, column: 3, scope: !114)
+!124 = !DILocation(line: 45, column: 3, scope: !114)
+!125 = !DILocation(line: 45, column: 3, scope: !114)
+!126 = !DILocation(line: 47, column: 3, scope: !114)
+!127 = !DILocation(line: 48, column: 3, scope: !114)
+!128 = !DILocation(line: 48, column: 3, scope: !114)
+!129 = !DILocation(line: 49, column: 3, scope: !114)
+!130 = !DILocation(line: 50, column: 3, scope: !114)
+!131 = !DILocation(line: 50, column: 3, scope: !114)
+!132 = !DILocation(line: 51, column: 3, scope: !114)
+!133 = !DILocation(line: 51, column: 3, scope: !114)
+!134 = !DILocation(line: 51, column: 3, scope: !114)
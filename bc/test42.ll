@@ -0,0 +1,94 @@
+; ModuleID = 'test42.bc'
+source_filename = "test42.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 (i32, i32)* @even(i32 %n, i32 (i32, i32)* %f, i32 (i32, i32)* %g) !dbg !106 {
+entry:
+  %cmp = icmp eq i32 %n, 0, !dbg !107
+  br i1 %cmp, label %if.then, label %if.end, !dbg !108
+
+if.then:
+  br label %return, !dbg !109
+
+if.end:
+  %sub = sub nsw i32 %n, 1, !dbg !110
+  %call = call i32 (i32, i32)* @odd(i32 %sub, i32 (i32, i32)* %g, i32 (i32, i32)* %f), !dbg !111
+  br label %return, !dbg !112
+
+return:
+  %retval.0 = phi i32 (i32, i32)* [ %f, %if.then ], [ %call, %if.end ]
+  ret i32 (i32, i32)* %retval.0, !dbg !113
+}
+
+define dso_local i32 (i32, i32)* @odd(i32 %n, i32 (i32, i32)* %f, i32 (i32, i32)* %g) !dbg !114 {
+entry:
+  %cmp = icmp eq i32 %n, 0, !dbg !115
+  br i1 %cmp, label %if.then, label %if.end, !dbg !116
+
+if.then:
+  br label %return, !dbg !117
+
+if.end:
+  %sub = sub nsw i32 %n, 1, !dbg !118
+  %call = call i32 (i32, i32)* @even(i32 %sub, i32 (i32, i32)* %g, i32 (i32, i32)* %f), !dbg !119
+  br label %return, !dbg !120
+
+return:
+  %retval.0 = phi i32 (i32, i32)* [ %f, %if.then ], [ %call, %if.end ]
+  ret i32 (i32, i32)* %retval.0, !dbg !121
+}
+
+define dso_local i32 @foo(i32 %n) !dbg !122 {
+entry:
+  %call = call i32 (i32, i32)* @even(i32 %n, i32 (i32, i32)* @plus, i32 (i32, i32)* @minus), !dbg !123
+  %call1 = call i32 %call(i32 1, i32 %n), !dbg !124
+  ret i32 %call1, !dbg !125
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test42.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "even", scope: !1, file: !1, line: 11, type: !5, scopeLine: 11, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 13, column: 3, scope: !106)
+!108 = !DILocation(line: 13, column: 3, scope: !106)
+!109 = !DILocation(line: 14, column: 3, scope: !106)
+!110 = !DILocation(line: 15, column: 3, scope: !106)
+!111 = !DILocation(line: 15, column: 3, scope: !106)
+!112 = !DILocation(line: 15, column: 3, scope: !106)
+!113 = !DILocation(line: 16, column: 3, scope: !106)
+!114 = distinct !DISubprogram(name: "odd", scope: !1, file: !1, line: 18, type: !5, scopeLine: 18, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!115 = !DILocation(line: 20, column: 3, scope: !114)
+!116 = !DILocation(line: 20, column: 3, scope: !114)
+!117 = !DILocation(line: 21, column: 3, scope: !114)
+!118 = !DILocation(line: 22, column: 3, scope: !114)
+!119 = !DILocation(line: 22, column: 3, scope: !114)
+!120 = !DILocation(line: 22, column: 3, scope: !114)
+!121 = !DILocation(line: 23, column: 3, scope: !114)
+!122 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 25, type: !5, scopeLine: 25, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!123 = !DILocation(line: 27, column: 3, scope: !122)
+!124 = !DILocation(line: 28, column: 3, scope: !122)
+!125 = !DILocation(line: 28, column: 3, scope: !122)
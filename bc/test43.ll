@@ -0,0 +1,64 @@
+; ModuleID = 'test43.bc'
+source_filename = "test43.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @apply(i32 (i32, i32)* %f, i32 %a, i32 %b) !dbg !106 {
+entry:
+  %call = call i32 %f(i32 %a, i32 %b), !dbg !107
+  ret i32 %call, !dbg !108
+}
+
+define dso_local i32 @twice(i32 (i32, i32)* %f, i32 %a) !dbg !109 {
+entry:
+  %call = call i32 @apply(i32 (i32, i32)* %f, i32 %a, i32 %a), !dbg !110
+  %call1 = call i32 @apply(i32 (i32, i32)* %f, i32 %a, i32 %call), !dbg !111
+  ret i32 %call1, !dbg !112
+}
+
+define dso_local i32 @foo(i32 %a) !dbg !113 {
+entry:
+  %call = call i32 @twice(i32 (i32, i32)* @plus, i32 %a), !dbg !114
+  %call1 = call i32 @apply(i32 (i32, i32)* @minus, i32 %a, i32 %a), !dbg !115
+  %add = add nsw i32 %call, %call1, !dbg !116
+  ret i32 %add, !dbg !117
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test43.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "apply", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 11, column: 3, scope: !106)
+!108 = !DILocation(line: 11, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "twice", scope: !1, file: !1, line: 14, type: !5, scopeLine: 14, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 16, column: 19, scope: !109)
+!111 = !DILocation(line: 16, column: 9, scope: !109)
+!112 = !DILocation(line: 16, column: 3, scope: !109)
+!113 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 19, type: !5, scopeLine: 19, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!114 = !DILocation(line: 21, column: 9, scope: !113)
+!115 = !DILocation(line: 21, column: 23, scope: !113)
+!116 = !DILocation(line: 21, column: 3, scope: !113)
+!117 = !DILocation(line: 21, column: 3, scope: !113)
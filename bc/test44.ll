@@ -0,0 +1,58 @@
+; ModuleID = 'test44.bc'
+source_filename = "test44.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @apply(i32 (i32, i32)* %f, i32 %a) !dbg !106 {
+entry:
+  %call = call i32 %f(i32 %a, i32 %a), !dbg !107
+  ret i32 %call, !dbg !108
+}
+
+define dso_local i32 @foo(i32 %a) !dbg !109 {
+entry:
+  %call = call i32 @apply(i32 (i32, i32)* @plus, i32 %a), !dbg !110
+  ret i32 %call, !dbg !111
+}
+
+define dso_local i32 @bar(i32 %a) !dbg !112 {
+entry:
+  %call = call i32 @apply(i32 (i32, i32)* @minus, i32 %a), !dbg !113
+  ret i32 %call, !dbg !114
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test44.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "apply", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 11, column: 3, scope: !106)
+!108 = !DILocation(line: 11, column: 3, scope: !106)
+!109 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 14, type: !5, scopeLine: 14, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 16, column: 3, scope: !109)
+!111 = !DILocation(line: 16, column: 3, scope: !109)
+!112 = distinct !DISubprogram(name: "bar", scope: !1, file: !1, line: 19, type: !5, scopeLine: 19, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!113 = !DILocation(line: 21, column: 3, scope: !112)
+!114 = !DILocation(line: 21, column: 3, scope: !112)
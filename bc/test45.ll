@@ -0,0 +1,59 @@
+; ModuleID = 'test45.bc'
+source_filename = "test45.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !106 {
+entry:
+  br label %while.cond, !dbg !107
+
+while.cond:
+  %p.0 = phi i32 (i32, i32)* [ @plus, %entry ], [ %q.0, %while.body ]
+  %q.0 = phi i32 (i32, i32)* [ @minus, %entry ], [ %p.0, %while.body ]
+  %x.addr.0 = phi i32 [ %x, %entry ], [ %dec, %while.body ]
+  %cmp = icmp sgt i32 %x.addr.0, 0, !dbg !108
+  br i1 %cmp, label %while.body, label %while.end, !dbg !109
+
+while.body:
+  %dec = add nsw i32 %x.addr.0, -1, !dbg !110
+  br label %while.cond, !dbg !111
+
+while.end:
+  %call = call i32 %p.0(i32 1, i32 %x.addr.0), !dbg !112
+  ret i32 %call, !dbg !113
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test45.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 3, scope: !100)
+!102 = !DILocation(line: 2, column: 3, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 3, scope: !103)
+!105 = !DILocation(line: 6, column: 3, scope: !103)
+!106 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 13, column: 2, scope: !106)
+!108 = !DILocation(line: 13, column: 10, scope: !106)
+!109 = !DILocation(line: 13, column: 2, scope: !106)
+!110 = !DILocation(line: 17, column: 4, scope: !106)
+!111 = !DILocation(line: 13, column: 2, scope: !106)
+!112 = !DILocation(line: 19, column: 9, scope: !106)
+!113 = !DILocation(line: 19, column: 2, scope: !106)
@@ -0,0 +1,76 @@
+; ModuleID = 'test46.bc'
+source_filename = "test46.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.table = type { i32, %struct.ops }
+%struct.ops = type { i32 (i32, i32)*, i32 (i32, i32)* }
+
+@t = dso_local global %struct.table { i32 0, %struct.ops { i32 (i32, i32)* @plus, i32 (i32, i32)* @minus } }, align 8
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !106 {
+entry:
+  %local = alloca %struct.table, align 8
+  %0 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @t, i32 0, i32 1, i32 0), align 8, !dbg !107
+  %ops = getelementptr inbounds %struct.table, %struct.table* %local, i32 0, i32 1, !dbg !108
+  %second = getelementptr inbounds %struct.ops, %struct.ops* %ops, i32 0, i32 1, !dbg !109
+  store i32 (i32, i32)* %0, i32 (i32, i32)** %second, align 8, !dbg !110
+  %1 = load i32 (i32, i32)*, i32 (i32, i32)** getelementptr inbounds (%struct.table, %struct.table* @t, i32 0, i32 1, i32 1), align 8, !dbg !111
+  %ops1 = getelementptr inbounds %struct.table, %struct.table* %local, i32 0, i32 1, !dbg !112
+  %first = getelementptr inbounds %struct.ops, %struct.ops* %ops1, i32 0, i32 0, !dbg !113
+  store i32 (i32, i32)* %1, i32 (i32, i32)** %first, align 8, !dbg !114
+  %ops2 = getelementptr inbounds %struct.table, %struct.table* %local, i32 0, i32 1, !dbg !115
+  %second3 = getelementptr inbounds %struct.ops, %struct.ops* %ops2, i32 0, i32 1, !dbg !116
+  %2 = load i32 (i32, i32)*, i32 (i32, i32)** %second3, align 8, !dbg !117
+  %call = call i32 %2(i32 1, i32 %x), !dbg !118
+  %ops4 = getelementptr inbounds %struct.table, %struct.table* %local, i32 0, i32 1, !dbg !119
+  %first5 = getelementptr inbounds %struct.ops, %struct.ops* %ops4, i32 0, i32 0, !dbg !120
+  %3 = load i32 (i32, i32)*, i32 (i32, i32)** %first5, align 8, !dbg !121
+  %call6 = call i32 %3(i32 1, i32 %x), !dbg !122
+  ret i32 %call6, !dbg !123
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test46.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 12, scope: !100)
+!102 = !DILocation(line: 2, column: 4, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 12, scope: !103)
+!105 = !DILocation(line: 6, column: 4, scope: !103)
+!106 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 21, type: !5, scopeLine: 21, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 24, column: 27, scope: !106)
+!108 = !DILocation(line: 24, column: 8, scope: !106)
+!109 = !DILocation(line: 24, column: 12, scope: !106)
+!110 = !DILocation(line: 24, column: 19, scope: !106)
+!111 = !DILocation(line: 25, column: 26, scope: !106)
+!112 = !DILocation(line: 25, column: 8, scope: !106)
+!113 = !DILocation(line: 25, column: 12, scope: !106)
+!114 = !DILocation(line: 25, column: 18, scope: !106)
+!115 = !DILocation(line: 26, column: 29, scope: !106)
+!116 = !DILocation(line: 26, column: 33, scope: !106)
+!117 = !DILocation(line: 26, column: 33, scope: !106)
+!118 = !DILocation(line: 27, column: 2, scope: !106)
+!119 = !DILocation(line: 28, column: 15, scope: !106)
+!120 = !DILocation(line: 28, column: 19, scope: !106)
+!121 = !DILocation(line: 28, column: 19, scope: !106)
+!122 = !DILocation(line: 28, column: 9, scope: !106)
+!123 = !DILocation(line: 28, column: 2, scope: !106)
@@ -0,0 +1,61 @@
+; ModuleID = 'test48.bc'
+source_filename = "test48.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local void @set(i32 (i32, i32)** %slot) !dbg !106 {
+entry:
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %slot, align 8, !dbg !107
+  ret void, !dbg !108
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !109 {
+entry:
+  %init = alloca void (i32 (i32, i32)**)*, align 8
+  %f = alloca i32 (i32, i32)*, align 8
+  store void (i32 (i32, i32)**)* @set, void (i32 (i32, i32)**)** %init, align 8, !dbg !110
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %f, align 8, !dbg !111
+  %0 = load void (i32 (i32, i32)**)*, void (i32 (i32, i32)**)** %init, align 8, !dbg !112
+  call void %0(i32 (i32, i32)** %f), !dbg !113
+  %1 = load i32 (i32, i32)*, i32 (i32, i32)** %f, align 8, !dbg !114
+  %call = call i32 %1(i32 %x, i32 %x), !dbg !115
+  ret i32 %call, !dbg !116
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test48.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 2, column: 12, scope: !100)
+!102 = !DILocation(line: 2, column: 4, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 5, type: !5, scopeLine: 5, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 6, column: 12, scope: !103)
+!105 = !DILocation(line: 6, column: 4, scope: !103)
+!106 = distinct !DISubprogram(name: "set", scope: !1, file: !1, line: 9, type: !5, scopeLine: 9, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 11, column: 8, scope: !106)
+!108 = !DILocation(line: 12, column: 1, scope: !106)
+!109 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 14, type: !5, scopeLine: 14, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!110 = !DILocation(line: 16, column: 9, scope: !109)
+!111 = !DILocation(line: 17, column: 8, scope: !109)
+!112 = !DILocation(line: 18, column: 2, scope: !109)
+!113 = !DILocation(line: 18, column: 2, scope: !109)
+!114 = !DILocation(line: 19, column: 9, scope: !109)
+!115 = !DILocation(line: 19, column: 9, scope: !109)
+!116 = !DILocation(line: 19, column: 2, scope: !109)
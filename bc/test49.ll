@@ -0,0 +1,115 @@
+; ModuleID = 'test49.bc'
+source_filename = "test49.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.fptr = type { i32 (i32, i32)* }
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !106 {
+entry:
+  %p = alloca %struct.fptr*, align 8
+  %q = alloca %struct.fptr*, align 8
+  %i = alloca i32, align 4
+  store %struct.fptr* null, %struct.fptr** %p, align 8, !dbg !107
+  store %struct.fptr* null, %struct.fptr** %q, align 8, !dbg !108
+  store i32 0, i32* %i, align 4, !dbg !109
+  br label %for.cond, !dbg !110
+
+for.cond:
+  %0 = load i32, i32* %i, align 4, !dbg !111
+  %cmp = icmp slt i32 %0, %x, !dbg !112
+  br i1 %cmp, label %for.body, label %for.end, !dbg !113
+
+for.body:
+  %call = call noalias i8* @malloc(i64 8), !dbg !114
+  %1 = bitcast i8* %call to %struct.fptr*, !dbg !115
+  store %struct.fptr* %1, %struct.fptr** %p, align 8, !dbg !116
+  %2 = load %struct.fptr*, %struct.fptr** %p, align 8, !dbg !117
+  %f = getelementptr inbounds %struct.fptr, %struct.fptr* %2, i32 0, i32 0, !dbg !118
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %f, align 8, !dbg !119
+  %3 = load i32, i32* %i, align 4, !dbg !120
+  %cmp1 = icmp eq i32 %3, 0, !dbg !121
+  br i1 %cmp1, label %if.then, label %for.inc, !dbg !122
+
+if.then:
+  %4 = load %struct.fptr*, %struct.fptr** %p, align 8, !dbg !123
+  store %struct.fptr* %4, %struct.fptr** %q, align 8, !dbg !124
+  br label %for.inc, !dbg !125
+
+for.inc:
+  %5 = load i32, i32* %i, align 4, !dbg !126
+  %inc = add nsw i32 %5, 1, !dbg !127
+  store i32 %inc, i32* %i, align 4, !dbg !128
+  br label %for.cond, !dbg !129
+
+for.end:
+  %6 = load %struct.fptr*, %struct.fptr** %p, align 8, !dbg !130
+  %f2 = getelementptr inbounds %struct.fptr, %struct.fptr* %6, i32 0, i32 0, !dbg !131
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %f2, align 8, !dbg !132
+  %7 = load %struct.fptr*, %struct.fptr** %q, align 8, !dbg !133
+  %f3 = getelementptr inbounds %struct.fptr, %struct.fptr* %7, i32 0, i32 0, !dbg !134
+  %8 = load i32 (i32, i32)*, i32 (i32, i32)** %f3, align 8, !dbg !135
+  %call4 = call i32 %8(i32 1, i32 %x), !dbg !136
+  ret i32 %call4, !dbg !137
+}
+
+declare dso_local noalias i8* @malloc(i64)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test49.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 6, type: !5, scopeLine: 6, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 7, column: 12, scope: !100)
+!102 = !DILocation(line: 7, column: 4, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 10, type: !5, scopeLine: 10, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 11, column: 12, scope: !103)
+!105 = !DILocation(line: 11, column: 4, scope: !103)
+!106 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 14, type: !5, scopeLine: 14, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 16, column: 15, scope: !106)
+!108 = !DILocation(line: 16, column: 23, scope: !106)
+!109 = !DILocation(line: 17, column: 11, scope: !106)
+!110 = !DILocation(line: 17, column: 7, scope: !106)
+!111 = !DILocation(line: 17, column: 18, scope: !106)
+!112 = !DILocation(line: 17, column: 20, scope: !106)
+!113 = !DILocation(line: 17, column: 2, scope: !106)
+!114 = !DILocation(line: 18, column: 22, scope: !106)
+!115 = !DILocation(line: 18, column: 7, scope: !106)
+!116 = !DILocation(line: 18, column: 5, scope: !106)
+!117 = !DILocation(line: 19, column: 3, scope: !106)
+!118 = !DILocation(line: 19, column: 6, scope: !106)
+!119 = !DILocation(line: 19, column: 13, scope: !106)
+!120 = !DILocation(line: 20, column: 7, scope: !106)
+!121 = !DILocation(line: 20, column: 9, scope: !106)
+!122 = !DILocation(line: 20, column: 7, scope: !106)
+!123 = !DILocation(line: 21, column: 8, scope: !106)
+!124 = !DILocation(line: 21, column: 6, scope: !106)
+!125 = !DILocation(line: 21, column: 4, scope: !106)
+!126 = !DILocation(line: 17, column: 27, scope: !106)
+!127 = !DILocation(line: 17, column: 27, scope: !106)
+!128 = !DILocation(line: 17, column: 27, scope: !106)
+!129 = !DILocation(line: 17, column: 2, scope: !106)
+!130 = !DILocation(line: 23, column: 2, scope: !106)
+!131 = !DILocation(line: 23, column: 5, scope: !106)
+!132 = !DILocation(line: 23, column: 12, scope: !106)
+!133 = !DILocation(line: 24, column: 9, scope: !106)
+!134 = !DILocation(line: 24, column: 12, scope: !106)
+!135 = !DILocation(line: 24, column: 12, scope: !106)
+!136 = !DILocation(line: 24, column: 9, scope: !106)
+!137 = !DILocation(line: 24, column: 2, scope: !106)
@@ -0,0 +1,70 @@
+; ModuleID = 'test50.bc'
+source_filename = "test50.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+%struct.big = type { i32 (i32, i32)*, [248 x i8], i32 (i32, i32)* }
+
+define dso_local i32 @plus(i32 %a, i32 %b) !dbg !100 {
+entry:
+  %add = add nsw i32 %a, %b, !dbg !101
+  ret i32 %add, !dbg !102
+}
+
+define dso_local i32 @minus(i32 %a, i32 %b) !dbg !103 {
+entry:
+  %sub = sub nsw i32 %a, %b, !dbg !104
+  ret i32 %sub, !dbg !105
+}
+
+define dso_local void @init(%struct.big* %o) !dbg !106 {
+entry:
+  %first = getelementptr inbounds %struct.big, %struct.big* %o, i32 0, i32 0, !dbg !107
+  store i32 (i32, i32)* @plus, i32 (i32, i32)** %first, align 8, !dbg !108
+  %last = getelementptr inbounds %struct.big, %struct.big* %o, i32 0, i32 2, !dbg !109
+  store i32 (i32, i32)* @minus, i32 (i32, i32)** %last, align 8, !dbg !110
+  ret void, !dbg !111
+}
+
+define dso_local i32 @foo(i32 %x) !dbg !112 {
+entry:
+  %b = alloca %struct.big, align 8
+  call void @init(%struct.big* %b), !dbg !113
+  %first = getelementptr inbounds %struct.big, %struct.big* %b, i32 0, i32 0, !dbg !114
+  %0 = load i32 (i32, i32)*, i32 (i32, i32)** %first, align 8, !dbg !115
+  %call = call i32 %0(i32 1, i32 %x), !dbg !116
+  %last = getelementptr inbounds %struct.big, %struct.big* %b, i32 0, i32 2, !dbg !117
+  %1 = load i32 (i32, i32)*, i32 (i32, i32)** %last, align 8, !dbg !118
+  %call1 = call i32 %1(i32 1, i32 %call), !dbg !119
+  ret i32 %call1, !dbg !120
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang version 10.0.0", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, enums: !2, splitDebugInlining: false, nameTableKind: None)
+!1 = !DIFile(filename: "test50.c", directory: "/root/repo/tests")
+!2 = !{}
+!3 = !{i32 7, !"Dwarf Version", i32 4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = !DISubroutineType(types: !2)
+!100 = distinct !DISubprogram(name: "plus", scope: !1, file: !1, line: 7, type: !5, scopeLine: 7, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!101 = !DILocation(line: 8, column: 12, scope: !100)
+!102 = !DILocation(line: 8, column: 4, scope: !100)
+!103 = distinct !DISubprogram(name: "minus", scope: !1, file: !1, line: 11, type: !5, scopeLine: 11, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!104 = !DILocation(line: 12, column: 12, scope: !103)
+!105 = !DILocation(line: 12, column: 4, scope: !103)
+!106 = distinct !DISubprogram(name: "init", scope: !1, file: !1, line: 15, type: !5, scopeLine: 15, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!107 = !DILocation(line: 17, column: 5, scope: !106)
+!108 = !DILocation(line: 17, column: 11, scope: !106)
+!109 = !DILocation(line: 18, column: 5, scope: !106)
+!110 = !DILocation(line: 18, column: 10, scope: !106)
+!111 = !DILocation(line: 19, column: 1, scope: !106)
+!112 = distinct !DISubprogram(name: "foo", scope: !1, file: !1, line: 21, type: !5, scopeLine: 21, flags: DIFlagPrototyped, spFlags: DISPFlagDefinition, unit: !0, retainedNodes: !2)
+!113 = !DILocation(line: 24, column: 2, scope: !112)
+!114 = !DILocation(line: 25, column: 8, scope: !112)
+!115 = !DILocation(line: 25, column: 8, scope: !112)
+!116 = !DILocation(line: 25, column: 6, scope: !112)
+!117 = !DILocation(line: 26, column: 11, scope: !112)
+!118 = !DILocation(line: 26, column: 11, scope: !112)
+!119 = !DILocation(line: 26, column: 9, scope: !112)
+!120 = !DILocation(line: 26, column: 2, scope: !112)
@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+#
+# Check the call sites reported for bc/testNN.ll against the "// line : callees"
+# comments at the end of tests/testNN.c.
+#
+#   ./check.sh [-bin assignment3] [-diff] [analysis options] [testNN ...]
+#
+#   ./check.sh -pta-bottom-up test42 test43
+#   ./check.sh -diff -pta-tiered           compare with the default mode instead
+#
+# Without test names every test that has expectations is checked (with -diff,
+# every test). Exits with 1 if any test fails.
+
+cd "$(dirname "$0")"
+bin=build/assignment3
+diff=0
+options=()
+tests=()
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -bin) bin=$2; shift ;;
+        -diff) diff=1 ;;
+        test*) tests+=("$1") ;;
+        *) options+=("$1") ;;
+    esac
+    shift
+done
+
+# "27 : plus, minus" -> "27 : minus,plus", one call site per line
+normalize() {
+    sed -E 's/\x1b\[[0-9;]*m//g; s#^[[:space:]]*(//)?[[:space:]]*##' | grep -E '^[0-9]+[[:space:]]*:' |
+        while IFS=: read -r line callees; do
+            echo "${line//[[:space:]]/} : $(echo "$callees" | tr ',' '\n' | tr -d ' \t' | grep -v '^$' | sort | paste -sd, -)"
+        done | sort -n
+}
+
+expected() {
+    if [ $diff -eq 1 ]; then
+        "$bin" "bc/$1.ll" 2>&1 | normalize
+    else
+        grep -E '^[[:space:]]*//[[:space:]]*[0-9]+[[:space:]]*:' "tests/$1.c" | normalize
+    fi
+}
+
+if [ ${#tests[@]} -eq 0 ]; then
+    for c in tests/test*.c; do
+        name=$(basename "$c" .c)
+        if [ $diff -eq 1 ] || grep -qE '^[[:space:]]*//[[:space:]]*[0-9]+[[:space:]]*:' "$c"; then
+            tests+=("$name")
+        fi
+    done
+fi
+
+failed=()
+for name in "${tests[@]}"; do
+    if [ ! -f "tests/$name.c" ] || [ ! -f "bc/$name.ll" ]; then
+        failed+=("$name")
+        echo "FAIL $name: no tests/$name.c or bc/$name.ll"
+        continue
+    fi
+    want=$(expected "$name")
+    got=$("$bin" "${options[@]}" "bc/$name.ll" 2>&1 | normalize)
+    if [ "$want" != "$got" ]; then
+        failed+=("$name")
+        echo "FAIL $name ${options[*]}"
+        diff <(echo "$want") <(echo "$got") | sed 's/^/    /'
+    fi
+done
+
+echo "${options[*]}: $((${#tests[@]} - ${#failed[@]})) of ${#tests[@]} passed"
+[ ${#failed[@]} -eq 0 ]
@@ -0,0 +1,22 @@
+#include <stdlib.h>
+struct fptr
+{
+	int (*p_fptr)(int, int);
+	char buf[16];
+};
+int plus(int a, int b) {
+   return a+b;
+}
+
+int foo(int n)
+{
+	struct fptr a_fptr;
+	a_fptr.p_fptr=plus;
+	char *p=(char *)&a_fptr;
+	for(int i=0;i<n;i++)
+		p++;
+	int (**q)(int, int)=(int (**)(int, int))p;
+	return (*q)(1,n);
+}
+
+// 19 : plus
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+struct node
+{
+	int (*p_fptr)(int, int);
+	struct node * next;
+};
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int times(int a, int b) {
+   return a*b;
+}
+
+struct node * walk(int n, struct node * list);
+
+int apply(int n, struct node * list)
+{
+	if(n>0)
+	{
+		struct node * r=walk(n,list);
+		return r->p_fptr(1,n);
+	}
+	return 0;
+}
+
+struct node * walk(int n, struct node * list)
+{
+	if(n==0)
+	{
+		apply(n,list);
+		return list;
+	}
+	struct node * q=walk(n-1,list);
+	return q->next;
+}
+
+int foo(int n)
+{
+	struct node c;
+	c.p_fptr=times;
+	c.next=0;
+	struct node b;
+	b.p_fptr=minus;
+	b.next=&c;
+	struct node a;
+	a.p_fptr=plus;
+	a.next=&b;
+	return apply(n,&a);
+}
+
+// 25 : walk
+// 26 : plus, minus, times
+// 35 : apply
+// 38 : walk
+// 53 : apply
@@ -0,0 +1,56 @@
+#include <stdlib.h>
+struct fptr
+{
+	int (*p_fptr)(int, int);
+};
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+struct fptr * last;
+
+void remember(struct fptr * p)
+{
+	last=p;
+}
+
+struct fptr * make()
+{
+	struct fptr * p=(struct fptr *)malloc(sizeof(struct fptr));
+	return p;
+}
+
+struct fptr * make_shared()
+{
+	struct fptr * p=(struct fptr *)malloc(sizeof(struct fptr));
+	remember(p);
+	return p;
+}
+
+int foo(int x)
+{
+	struct fptr * a=make();
+	a->p_fptr=plus;
+	struct fptr * b=make();
+	b->p_fptr=minus;
+	a->p_fptr(1,x);
+	struct fptr * c=make_shared();
+	c->p_fptr=plus;
+	struct fptr * d=make_shared();
+	d->p_fptr=minus;
+	return last->p_fptr(1,x);
+}
+
+// 23 : malloc
+// 29 : malloc
+// 30 : remember
+// 36 : make
+// 38 : make
+// 40 : plus
+// 41 : make_shared
+// 43 : make_shared
+// 45 : plus, minus
@@ -0,0 +1,42 @@
+#include <string.h>
+struct ops
+{
+	int (*op)(int, int);
+};
+
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int times(int a, int b) {
+   return a*b;
+}
+
+struct ops table = { times };
+
+void set(struct ops * o, int (*f)(int, int))
+{
+	o->op=f;
+}
+
+int foo(int x)
+{
+	struct ops local;
+	local.op=plus;
+	struct ops shared;
+	set(&shared, minus);
+	struct ops copy;
+	memcpy(&copy, &table, sizeof(struct ops));
+	x=local.op(1,x);
+	x=shared.op(1,x);
+	return copy.op(1,x);
+}
+
+// 31 : set
+// 34 : plus
+// 35 : minus
+// 36 : times
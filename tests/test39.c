@@ -0,0 +1,36 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+void trace(int x)
+{
+}
+
+void (*hook)(int);
+
+int twice(int (*f)(int, int), int x)
+{
+	return f(x,x);
+}
+
+int foo(int x)
+{
+	int debug = 0;
+	if (debug)
+	{
+		hook = trace;
+		x = minus(1, x);
+	}
+	x = twice(plus, x);
+	if (x > 2)
+		hook(x);
+	return x;
+}
+
+// 17 : plus
+// 28 : twice
+// 30 :
@@ -0,0 +1,33 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int twice(int x)
+{
+	return plus(x, x);
+}
+
+int count(int x)
+{
+	int verbose = 0;
+	if (verbose)
+		x = twice(x);
+	return minus(x, 1);
+}
+
+int foo(int x)
+{
+	int (*f)(int, int) = plus;
+	if (x > 1)
+		f = minus;
+	x = count(x);
+	return f(1, x);
+}
+
+// 19 : minus
+// 27 : count
+// 28 : minus, plus
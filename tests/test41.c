@@ -0,0 +1,59 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int times(int a, int b) {
+   return a*b;
+}
+
+struct ops
+{
+	int (*first)(int, int);
+	int (*second)(int, int);
+};
+
+struct table
+{
+	int id;
+	struct ops ops;
+};
+
+struct table calc = { 1, { plus, minus } };
+struct ops * current = &calc.ops;
+int (*steps[2])(int, int) = { times, plus };
+
+void reset(void)
+{
+	calc.ops.second = times;
+}
+
+void keep(void)
+{
+}
+
+int foo(int x)
+{
+	void (*update)(void) = keep;
+	x = calc.ops.second(1, x);
+	x = current->first(1, x);
+	if (x > 1)
+	{
+		current->first = times;
+		update = reset;
+	}
+	x = calc.ops.first(1, x);
+	update();
+	x = calc.ops.second(1, x);
+	return steps[1](1, x);
+}
+
+// 41 : minus
+// 42 : plus
+// 48 : plus, times
+// 49 : keep, reset
+// 50 : minus, times
+// 51 : plus, times
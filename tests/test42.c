@@ -0,0 +1,34 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int (*odd(int n, int (*f)(int, int), int (*g)(int, int)))(int, int);
+
+int (*even(int n, int (*f)(int, int), int (*g)(int, int)))(int, int)
+{
+	if(n==0)
+		return f;
+	return odd(n-1,g,f);
+}
+
+int (*odd(int n, int (*f)(int, int), int (*g)(int, int)))(int, int)
+{
+	if(n==0)
+		return f;
+	return even(n-1,g,f);
+}
+
+int foo(int n)
+{
+	int (*h)(int, int)=even(n,plus,minus);
+	return h(1,n);
+}
+
+// 15 : odd
+// 22 : even
+// 27 : even
+// 28 : plus, minus
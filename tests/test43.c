@@ -0,0 +1,26 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int apply(int (*f)(int, int), int a, int b)
+{
+	return f(a,b);
+}
+
+int twice(int (*f)(int, int), int a)
+{
+	return apply(f,a,apply(f,a,a));
+}
+
+int foo(int a)
+{
+	return twice(plus,a)+apply(minus,a,a);
+}
+
+// 11 : plus, minus
+// 16 : apply
+// 21 : twice, apply
@@ -0,0 +1,26 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int apply(int (*f)(int, int), int a)
+{
+	return f(a,a);
+}
+
+int foo(int a)
+{
+	return apply(plus,a);
+}
+
+int bar(int a)
+{
+	return apply(minus,a);
+}
+
+// 11 : plus, minus
+// 16 : apply
+// 21 : apply
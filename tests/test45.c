@@ -0,0 +1,22 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int foo(int x)
+{
+	int (*p)(int, int)=plus;
+	int (*q)(int, int)=minus;
+	while (x>0) {
+		int (*t)(int, int)=p;
+		p=q;
+		q=t;
+		x--;
+	}
+	return p(1,x);
+}
+
+// 19 : plus, minus
@@ -0,0 +1,32 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+struct ops {
+	int (*first)(int, int);
+	int (*second)(int, int);
+};
+
+struct table {
+	int tag;
+	struct ops ops;
+};
+
+struct table t = {0, {plus, minus}};
+
+int foo(int x)
+{
+	struct table local;
+	local.ops.second = t.ops.first;
+	local.ops.first = t.ops.second;
+	int (*f)(int, int) = local.ops.second;
+	f(1, x);
+	return local.ops.first(1, x);
+}
+
+// 27 : plus
+// 28 : minus
@@ -0,0 +1,33 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+void set(int (**slot)(int, int), int (*f)(int, int))
+{
+	*slot = f;
+}
+
+void swap_in(int (**slot)(int, int))
+{
+	set(slot, plus);
+	int (*g)(int, int) = *slot;
+	set(slot, minus);
+	g(1, 2);
+}
+
+int foo(int x)
+{
+	int (*f)(int, int) = plus;
+	swap_in(&f);
+	return f(x, x);
+}
+
+// 16 : set
+// 18 : set
+// 19 : plus
+// 25 : swap_in
+// 26 : minus
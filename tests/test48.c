@@ -0,0 +1,23 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+void set(int (**slot)(int, int))
+{
+	*slot = minus;
+}
+
+int foo(int x)
+{
+	void (*init)(int (**)(int, int)) = set;
+	int (*f)(int, int) = plus;
+	init(&f);
+	return f(x, x);
+}
+
+// 18 : set
+// 19 : minus
@@ -0,0 +1,28 @@
+#include <stdlib.h>
+struct fptr
+{
+	int (*p_fptr)(int, int);
+};
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+int foo(int x)
+{
+	struct fptr *p = 0, *q = 0;
+	for (int i = 0; i < x; i++) {
+		p = (struct fptr *)malloc(sizeof(struct fptr));
+		p->p_fptr = plus;
+		if (i == 0)
+			q = p;
+	}
+	p->p_fptr = minus;
+	return q->p_fptr(1, x);
+}
+
+// 18 : malloc
+// 24 : plus, minus
@@ -0,0 +1,31 @@
+struct big
+{
+	int (*first)(int, int);
+	char pad[248];
+	int (*last)(int, int);
+};
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+void init(struct big *o)
+{
+	o->first = plus;
+	o->last = minus;
+}
+
+int foo(int x)
+{
+	struct big b;
+	init(&b);
+	x = b.first(1, x);
+	return b.last(1, x);
+}
+
+// 24 : init
+// 25 : plus
+// 26 : minus
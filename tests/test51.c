@@ -0,0 +1,21 @@
+int plus(int a, int b) {
+   return a+b;
+}
+
+int minus(int a, int b) {
+   return a-b;
+}
+
+struct box {
+	int tag;
+	char data[16];
+};
+
+int foo(int x)
+{
+	struct box s;
+	*(int (**)(int, int)) s.data = plus;
+	return (*(int (**)(int, int)) s.data)(1, x);
+}
+
+// 18 : plus
@@ -6,6 +6,7 @@
 #define UTILS_H
 
 #include <iostream>
+#include <mutex>
 #include <llvm/Support/raw_ostream.h>
 
 #define Info Log(LogLevel::info)
@@ -46,6 +47,9 @@ private:
 };
 
 void Log::output() {
+    // 分析线程会并发打日志
+    static std::mutex mtx;
+    std::lock_guard<std::mutex> lock(mtx);
     if (_level == LogLevel::info) {
         llvm::errs() << "\033[32m[Info]: " + _message + "\033[0m ";
     } else if (_level == LogLevel::warning) {